@@ -18,18 +18,96 @@ namespace dbUtils
 			return false;
 		}
 
+		if (!(db.CreateTable("CATEGORIES", "ID INTEGER PRIMARY KEY AUTOINCREMENT, NAME TEXT NOT NULL UNIQUE")))
+		{
+			return false;
+		}
+
 		if (!(db.CreateTable("INVENTORY", "ID INTEGER PRIMARY KEY AUTOINCREMENT, "
-			"CATEGORY TEXT NOT NULL, "
+			"CATEGORY_ID INTEGER NOT NULL REFERENCES CATEGORIES(ID), "
 			"PRODUCT_NAME TEXT NOT NULL UNIQUE, "
 			"AMOUNT INTEGER NOT NULL DEFAULT 0, "
 			"PRICE REAL NOT NULL DEFAULT 0.0, "
 			"SIZE TEXT, "
 			"DESCRIPTION TEXT, "
+			"CREATED_AT DATETIME DEFAULT CURRENT_TIMESTAMP, "
+			"SIZE_QUANTITY INTEGER NOT NULL DEFAULT 0, "
+			"SIZE_UNIT INTEGER NOT NULL DEFAULT 0")))
+		{
+			return false;
+		}
+
+		if (!(db.MigrateCategories()))
+		{
+			return false;
+		}
+
+		if (!(db.MigrateItemSizes()))
+		{
+			return false;
+		}
+
+		// Category lookups and listings read one category's range, already in name order
+		if (!(db.CreateIndex("IDX_INVENTORY_CATEGORY", "INVENTORY", "CATEGORY_ID, PRODUCT_NAME")))
+		{
+			return false;
+		}
+
+		// Sort orders of the full listing, each index also holds ID (the rowid) to break ties
+		if (!(db.CreateIndex("IDX_INVENTORY_PRICE", "INVENTORY", "PRICE"))
+			|| !(db.CreateIndex("IDX_INVENTORY_AMOUNT", "INVENTORY", "AMOUNT"))
+			|| !(db.CreateIndex("IDX_INVENTORY_CREATED", "INVENTORY", "CREATED_AT")))
+		{
+			return false;
+		}
+
+		if (!(db.SetupSearch()))
+		{
+			return false;
+		}
+
+		// Append-only stock ledger, rows outlive the product they belong to
+		if (!(db.CreateTable("STOCK_MOVEMENTS", "ID INTEGER PRIMARY KEY AUTOINCREMENT, "
+			"ITEM_ID INTEGER NOT NULL, "
+			"DELTA INTEGER NOT NULL, "
+			"AMOUNT_AFTER INTEGER NOT NULL, "
+			"REASON TEXT NOT NULL, "
 			"CREATED_AT DATETIME DEFAULT CURRENT_TIMESTAMP")))
 		{
 			return false;
 		}
 
+		const char* totalsColumns = "UNITS_IN INTEGER NOT NULL DEFAULT 0, "
+			"UNITS_OUT INTEGER NOT NULL DEFAULT 0, "
+			"UNITS_SOLD INTEGER NOT NULL DEFAULT 0, "
+			"MOVEMENTS INTEGER NOT NULL DEFAULT 0, ";
+
+		if (!(db.CreateTable("STOCK_MOVEMENTS_HOURLY", std::string("ITEM_ID INTEGER NOT NULL, HOUR TEXT NOT NULL, ") + totalsColumns + "PRIMARY KEY (ITEM_ID, HOUR)")))
+		{
+			return false;
+		}
+
+		if (!(db.CreateTable("STOCK_MOVEMENTS_DAILY", std::string("ITEM_ID INTEGER NOT NULL, DAY TEXT NOT NULL, ") + totalsColumns + "PRIMARY KEY (ITEM_ID, DAY)")))
+		{
+			return false;
+		}
+
+		// Each movement is added to its hour and day as it is written, so reports read a few rows instead of the ledger
+		auto rollUp = [](const std::string& table, const std::string& column, const std::string& bucket) {
+			return "INSERT INTO " + table + " (ITEM_ID, " + column + ", UNITS_IN, UNITS_OUT, UNITS_SOLD, MOVEMENTS) "
+				"VALUES (NEW.ITEM_ID, " + bucket + ", MAX(NEW.DELTA, 0), MAX(-NEW.DELTA, 0), "
+				"CASE WHEN NEW.REASON = 'sale' THEN -NEW.DELTA ELSE 0 END, 1) "
+				"ON CONFLICT (ITEM_ID, " + column + ") DO UPDATE SET UNITS_IN = UNITS_IN + excluded.UNITS_IN, "
+				"UNITS_OUT = UNITS_OUT + excluded.UNITS_OUT, UNITS_SOLD = UNITS_SOLD + excluded.UNITS_SOLD, MOVEMENTS = MOVEMENTS + 1; ";
+		};
+
+		if (!(db.CreateTrigger("TRG_STOCK_MOVEMENTS_ROLLUP", "AFTER INSERT ON STOCK_MOVEMENTS BEGIN "
+			+ rollUp("STOCK_MOVEMENTS_HOURLY", "HOUR", "strftime('%Y-%m-%d %H:00', NEW.CREATED_AT)")
+			+ rollUp("STOCK_MOVEMENTS_DAILY", "DAY", "date(NEW.CREATED_AT)") + "END")))
+		{
+			return false;
+		}
+
 		return true;
 	}
 
@@ -52,8 +130,12 @@ namespace dbUtils
 		std::cout << "6 = Update Item Information\n";
 		std::cout << "7 = Add Item To Inventory\n";
 		std::cout << "8 = Remove Item From Inventory\n";
-		std::cout << "9 = LogOut\n";
-		std::cout << "10 = Exit\n\n";
+		std::cout << "9 = Adjust Item Stock\n";
+		std::cout << "10 = Checkout Order\n";
+		std::cout << "11 = Stock Movement Report\n";
+		std::cout << "12 = Stock Weight & Volume\n";
+		std::cout << "13 = LogOut\n";
+		std::cout << "14 = Exit\n\n";
 		std::cout << "Input: ";
 	}
 }
@@ -126,10 +208,25 @@ namespace invUtils
 		return true;
 	}
 
-	void get_product_size(std::string& itemSize)
+	bool get_product_size(std::string& itemSize)
 	{
-		std::cout << "Item Size (kg/grams/tonnes): ";
+		ItemSize size;
+
+		std::cout << "Item Size (eg. 500g, 1.5kg, 2 tonnes, 330ml, 1l): ";
 		std::getline(std::cin >> std::ws, itemSize);
+
+		if (!ItemSize::Parse(itemSize.c_str(), size) || size.baseQuantity <= 0)
+		{
+			std::cout << "\nInvalid Size\n";
+			std::cout << "\nPress Enter To Continue . . .";
+			std::cin.get();
+
+			return false;
+		}
+
+		// Stored the same way whatever way it was typed
+		itemSize = size.Format();
+		return true;
 	}
 
 	void get_product_description(std::string& itemDesc)
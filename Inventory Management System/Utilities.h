@@ -16,6 +16,6 @@ namespace invUtils
 	void get_product_name(std::string& itemName);
 	bool get_product_amount(int& itemAmount);
 	bool get_product_price(double& itemPrice);
-	void get_product_size(std::string& itemSize);
+	bool get_product_size(std::string& itemSize);
 	void get_product_description(std::string& itemDesc);
 }
@@ -2,29 +2,156 @@
 
 #include <string>
 #include <vector>
+#include <functional>
 #include "sqlite3.h"
+#include "TrigramIndex.h"
+#include "ItemSize.h"
 
 struct InventoryItem
 {
 	std::string category;
 	std::string productName;
-	int amount;
-	double price;
+	int amount{ 0 };
+	double price{ 0.0 };
 	std::string size;
 	std::string description;
 	std::string createdAt;
+	int id{ 0 };
+};
+
+// One line of a batched stock change: delta is added to the item's AMOUNT, newAmount is filled in once applied
+struct StockAdjustment
+{
+	int itemID;
+	int delta;
+	int newAmount{ 0 };
+	bool applied{ false };
+};
+
+enum class OrderLineStatus
+{
+	Pending,
+	Sold,
+	NotFound,
+	OutOfStock,
+	InvalidQuantity
+};
+
+// One product of an order, the fields below quantity are filled in by Checkout (remaining is the stock left
+// after a sold line, or the stock on hand for an out of stock one)
+struct OrderLine
+{
+	std::string productName;
+	int quantity;
+	OrderLineStatus status{ OrderLineStatus::Pending };
+	int itemID{ 0 };
+	int remaining{ 0 };
+	double price{ 0.0 };
+};
+
+struct Order
+{
+	std::vector<OrderLine> lines;
+	double total{ 0.0 };
+};
+
+// Position of GetItemsByCategory in a category, start with a default one and pass it back for every next page
+struct CategoryCursor
+{
+	std::string productName;
+	bool atStart{ true };
+};
+
+enum class ItemSortOrder
+{
+	Name,
+	Price,
+	Amount,
+	Created
+};
+
+// Where a listing of the whole inventory stopped: the sort key and ID of the last row shown
+struct ItemCursor
+{
+	ItemSortOrder order{ ItemSortOrder::Name };
+	bool atStart{ true };
+	std::string lastText;
+	double lastNumber{ 0.0 };
+	int lastID{ 0 };
+};
+
+// One INVENTORY row as read by GetItemsPage. The text points into SQLite's row and is only valid inside the visitor
+struct InventoryRow
+{
+	const char* category;
+	const char* productName;
+	int amount;
+	double price;
+	const char* size;
+	const char* description;
+	const char* createdAt;
+	int id;
+};
+
+using InventoryRowVisitor = std::function<void(const InventoryRow&)>;
+
+// One product found by SearchItems, similar is set when it was only matched by a name that looks like the query
+struct SearchResult
+{
+	int itemID{ 0 };
+	std::string category;
+	std::string productName;
+	int amount{ 0 };
+	double price{ 0.0 };
+	bool similar{ false };
+};
+
+// Size of the stock on hand in one category, unsized counts the items whose size is not a known weight or volume
+struct CategorySizeTotals
+{
+	std::string category;
+	long long grams;
+	long long millilitres;
+	int unsized;
+};
+
+// Stock movements of one item rolled up per hour ("2026-01-31 14:00") or per day ("2026-01-31")
+struct StockMovementTotals
+{
+	std::string period;
+	int unitsIn;
+	int unitsOut;
+	int unitsSold;
+	int movements;
 };
 
 class Database
 {
 private:
 	sqlite3* db;
+	TrigramIndex nameTrigrams;
+	bool fullTextSearch;
+
+	bool BeginTransaction(const char* action);
+	bool CommitTransaction(const char* action);
+	void RollbackTransaction();
+	sqlite3_stmt* PrepareMovement();
+	bool RecordMovement(sqlite3_stmt* movement_stmt, int itemID, int delta, int amountAfter, const char* reason);
+	bool RecordMovement(int itemID, int delta, int amountAfter, const char* reason);
+	bool InternCategory(const std::string& name, int& categoryID);
+	bool HasTrigger(const std::string& triggerName);
 public:
 	Database();
 	~Database();
 
 	bool OpenDatabase(const std::string& fileName);
 	bool CreateTable(const std::string& tableName, const std::string& columns);
+	bool CreateTrigger(const std::string& triggerName, const std::string& definition);
+	bool CreateIndex(const std::string& indexName, const std::string& tableName, const std::string& columns);
+	bool HasColumn(const std::string& tableName, const std::string& columnName);
+	bool MigrateCategories();
+	bool MigrateItemSizes();
+	bool SetupSearch();
 	bool ValidateUser(const std::string& username, const std::string& password);
 	bool InsertUser(const std::string& username, const std::string& password);
 	bool RemoveUser(const std::string& username, const std::string& password);
@@ -33,7 +160,14 @@ public:
 	bool ModifyItem(const std::string& productName, const InventoryItem& object);
 	bool InsertItem(const InventoryItem& object);
 	bool RemoveItem(const std::string& productName);
+	bool AdjustStock(int itemID, int delta, int& newAmount);
+	bool AdjustStock(std::vector<StockAdjustment>& adjustments);
+	bool Checkout(Order& order);
 
 	bool GetItem(InventoryItem& object);
-	std::vector<InventoryItem> GetAllItems();
+	int GetItemsPage(ItemCursor& cursor, int pageSize, const InventoryRowVisitor& visitor);
+	std::vector<InventoryItem> GetItemsByCategory(const std::string& category, CategoryCursor& cursor, int pageSize);
+	std::vector<SearchResult> SearchItems(const std::string& query, int limit, const std::string& category = "");
+	std::vector<CategorySizeTotals> GetSizeTotals();
+	std::vector<StockMovementTotals> GetMovementTotals(int itemID, bool hourly, int periods);
 };
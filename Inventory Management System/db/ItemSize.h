@@ -0,0 +1,135 @@
+#pragma once
+
+#include <string>
+#include <cstring>
+#include <cctype>
+
+// Units a size can be written in, stored as INVENTORY.SIZE_UNIT. Weights are between Grams and Tonnes and
+// volumes between Millilitres and Litres, so a range of values selects one kind
+enum class SizeUnit
+{
+	Unknown = 0,
+	Grams = 1,
+	Kilograms = 2,
+	Tonnes = 3,
+	Millilitres = 4,
+	Litres = 5
+};
+
+// An item size as a whole number of grams or millilitres (INVENTORY.SIZE_QUANTITY) and the unit it was written
+// in, so sizes can be compared and summed while "1.5kg" still reads as "1.5kg"
+struct ItemSize
+{
+	long long baseQuantity{ 0 };
+	SizeUnit unit{ SizeUnit::Unknown };
+
+	static long long Factor(SizeUnit unit)
+	{
+		return unit == SizeUnit::Kilograms || unit == SizeUnit::Litres ? 1000
+			: unit == SizeUnit::Tonnes ? 1000000 : 1;
+	}
+
+	static const char* Suffix(SizeUnit unit)
+	{
+		return unit == SizeUnit::Grams ? "g" : unit == SizeUnit::Kilograms ? "kg" : unit == SizeUnit::Tonnes ? "t"
+			: unit == SizeUnit::Millilitres ? "ml" : unit == SizeUnit::Litres ? "l" : "";
+	}
+
+	// Reads "500g", "1.5 kg", "2 Tonnes", "330ml" or "1,5l" in one pass without allocating. A size without a
+	// number ("grams") is 0 of that unit, false when the unit is missing or not one of the above
+	static bool Parse(const char* text, ItemSize& size)
+	{
+		size = ItemSize{};
+		if (!text)
+			return false;
+
+		const char* c = text;
+		while (*c == ' ' || *c == '\t')
+			c++;
+
+		// Up to 6 decimals are kept, enough to turn any tonnes value into whole grams
+		long long whole{ 0 };
+		long long decimals{ 0 };
+		long long scale{ 1 };
+		for (; std::isdigit(static_cast<unsigned char>(*c)); c++)
+		{
+			if (whole >= 100000000)
+				return false;
+
+			whole = whole * 10 + (*c - '0');
+		}
+
+		if (*c == '.' || *c == ',')
+		{
+			for (c++; std::isdigit(static_cast<unsigned char>(*c)); c++)
+			{
+				if (scale < 1000000)
+				{
+					decimals = decimals * 10 + (*c - '0');
+					scale *= 10;
+				}
+			}
+		}
+
+		while (*c == ' ' || *c == '\t')
+			c++;
+
+		char word[16];
+		size_t length{ 0 };
+		for (; std::isalpha(static_cast<unsigned char>(*c)); c++)
+		{
+			if (length == sizeof(word) - 1)
+				return false;
+
+			word[length++] = static_cast<char>(std::tolower(static_cast<unsigned char>(*c)));
+		}
+
+		word[length] = '\0';
+
+		while (*c == ' ' || *c == '\t' || *c == '.')
+			c++;
+
+		if (*c != '\0')
+			return false;
+
+		static const struct { const char* word; SizeUnit unit; } units[] = {
+			{ "g", SizeUnit::Grams }, { "gr", SizeUnit::Grams }, { "gram", SizeUnit::Grams }, { "grams", SizeUnit::Grams },
+			{ "kg", SizeUnit::Kilograms }, { "kgs", SizeUnit::Kilograms }, { "kilo", SizeUnit::Kilograms }, { "kilos", SizeUnit::Kilograms },
+			{ "kilogram", SizeUnit::Kilograms }, { "kilograms", SizeUnit::Kilograms },
+			{ "t", SizeUnit::Tonnes }, { "ton", SizeUnit::Tonnes }, { "tons", SizeUnit::Tonnes }, { "tonne", SizeUnit::Tonnes }, { "tonnes", SizeUnit::Tonnes },
+			{ "ml", SizeUnit::Millilitres }, { "millilitre", SizeUnit::Millilitres }, { "millilitres", SizeUnit::Millilitres },
+			{ "milliliter", SizeUnit::Millilitres }, { "milliliters", SizeUnit::Millilitres },
+			{ "l", SizeUnit::Litres }, { "ltr", SizeUnit::Litres }, { "litre", SizeUnit::Litres }, { "litres", SizeUnit::Litres },
+			{ "liter", SizeUnit::Litres }, { "liters", SizeUnit::Litres }
+		};
+
+		for (const auto& entry : units)
+		{
+			if (std::strcmp(word, entry.word) == 0)
+			{
+				size.unit = entry.unit;
+				size.baseQuantity = whole * Factor(entry.unit) + (decimals * Factor(entry.unit) + scale / 2) / scale;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Back to text in its own unit with no trailing zeros: "1.5kg", "500g", "2l"
+	std::string Format() const
+	{
+		long long factor = Factor(unit);
+		std::string text = std::to_string(baseQuantity / factor);
+
+		long long remainder = baseQuantity % factor;
+		if (remainder != 0)
+		{
+			std::string decimals = std::to_string(factor + remainder).substr(1);
+			decimals.erase(decimals.find_last_not_of('0') + 1);
+			text += '.' + decimals;
+		}
+
+		return text + Suffix(unit);
+	}
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+
+// In-memory trigram index over product names for typo tolerant search. Every name is lowercased, padded
+// with spaces and cut into overlapping three letter pieces. A query scores each name by the pieces they
+// share, so "choclate mlik" still finds "Chocolate Milk"
+class TrigramIndex
+{
+private:
+	std::unordered_map<uint32_t, std::vector<int>> postings;
+	std::vector<uint16_t> trigramCounts; // Distinct trigrams of each indexed item ID, 0 when the ID is not indexed
+	std::vector<uint16_t> shared; // Per search scratch counters, indexed by item ID and cleared after every search
+	std::vector<int> touched;
+
+	static std::vector<uint32_t> Trigrams(const std::string& text)
+	{
+		// Words are separated by one space and padded like "  word ", so short words and word starts count too
+		std::string padded = "  ";
+		for (char c : text)
+		{
+			if (std::isalnum(static_cast<unsigned char>(c)))
+				padded += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			else if (padded.back() != ' ')
+				padded += "  ";
+		}
+
+		if (padded.back() != ' ')
+			padded += ' ';
+
+		std::vector<uint32_t> trigrams;
+		for (size_t i = 0; i + 2 < padded.size(); i++)
+		{
+			if (padded[i + 1] == ' ' && padded[i + 2] == ' ')
+				continue;
+
+			trigrams.push_back((static_cast<uint32_t>(static_cast<unsigned char>(padded[i])) << 16)
+				| (static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 1])) << 8)
+				| static_cast<uint32_t>(static_cast<unsigned char>(padded[i + 2])));
+		}
+
+		std::sort(trigrams.begin(), trigrams.end());
+		trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+		return trigrams;
+	}
+public:
+	void Clear()
+	{
+		postings.clear();
+		trigramCounts.clear();
+		shared.clear();
+		touched.clear();
+	}
+
+	void Add(int itemID, const std::string& name)
+	{
+		if (itemID <= 0)
+			return;
+
+		std::vector<uint32_t> trigrams = Trigrams(name);
+		for (uint32_t trigram : trigrams)
+			postings[trigram].push_back(itemID);
+
+		if (static_cast<size_t>(itemID) >= trigramCounts.size())
+		{
+			trigramCounts.resize(static_cast<size_t>(itemID) + 1, 0);
+			shared.resize(trigramCounts.size(), 0);
+		}
+
+		trigramCounts[itemID] = static_cast<uint16_t>(std::min<size_t>(trigrams.size(), UINT16_MAX));
+	}
+
+	void Remove(int itemID, const std::string& name)
+	{
+		for (uint32_t trigram : Trigrams(name))
+		{
+			auto posting = postings.find(trigram);
+			if (posting == postings.end())
+				continue;
+
+			std::vector<int>& ids = posting->second;
+			ids.erase(std::remove(ids.begin(), ids.end(), itemID), ids.end());
+			if (ids.empty())
+				postings.erase(posting);
+		}
+
+		if (itemID > 0 && static_cast<size_t>(itemID) < trigramCounts.size())
+			trigramCounts[itemID] = 0;
+	}
+
+	// Best matches first as (item ID, similarity), where similarity = shared / (query + name - shared) trigrams
+	std::vector<std::pair<int, double>> Search(const std::string& query, size_t limit, double minSimilarity = 0.3)
+	{
+		std::vector<std::pair<int, double>> matches;
+
+		std::vector<uint32_t> trigrams = Trigrams(query);
+		if (trigrams.empty() || limit == 0)
+			return matches;
+
+		for (uint32_t trigram : trigrams)
+		{
+			auto posting = postings.find(trigram);
+			if (posting == postings.end())
+				continue;
+
+			for (int itemID : posting->second)
+			{
+				if (shared[itemID]++ == 0)
+					touched.push_back(itemID);
+			}
+		}
+
+		for (int itemID : touched)
+		{
+			double similarity = static_cast<double>(shared[itemID]) / (trigrams.size() + trigramCounts[itemID] - shared[itemID]);
+			if (similarity >= minSimilarity)
+				matches.push_back({ itemID, similarity });
+
+			shared[itemID] = 0;
+		}
+
+		touched.clear();
+
+		size_t count = std::min(limit, matches.size());
+		std::partial_sort(matches.begin(), matches.begin() + count, matches.end(), [](const std::pair<int, double>& a, const std::pair<int, double>& b) {
+			return a.second != b.second ? a.second > b.second : a.first < b.first;
+		});
+
+		matches.resize(count);
+		return matches;
+	}
+};
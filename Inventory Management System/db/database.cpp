@@ -1,7 +1,9 @@
 #include <iostream>
+#include <cctype>
+#include <limits>
 #include "Database.h"
 
-Database::Database() : db(nullptr) {}
+Database::Database() : db(nullptr), fullTextSearch(false) {}
 
 Database::~Database()
 {
@@ -44,6 +46,322 @@ bool Database::CreateTable(const std::string& tableName, const std::string& colu
 	return false;
 }
 
+bool Database::CreateTrigger(const std::string& triggerName, const std::string& definition)
+{
+	std::string SQL = "CREATE TRIGGER IF NOT EXISTS " + triggerName + " " + definition + ";";
+
+	int response = sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr);
+	if (response != SQLITE_OK)
+		std::cerr << "\nFailed to create database trigger " << triggerName << ": " << sqlite3_errmsg(db) << '\n';
+	else
+		return true;
+
+	return false;
+}
+
+bool Database::CreateIndex(const std::string& indexName, const std::string& tableName, const std::string& columns)
+{
+	std::string SQL = "CREATE INDEX IF NOT EXISTS " + indexName + " ON " + tableName + " (" + columns + ");";
+
+	int response = sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr);
+	if (response != SQLITE_OK)
+		std::cerr << "\nFailed to create database index " << indexName << ": " << sqlite3_errmsg(db) << '\n';
+	else
+		return true;
+
+	return false;
+}
+
+bool Database::HasColumn(const std::string& tableName, const std::string& columnName)
+{
+	const char* SQL = "SELECT count(*) FROM pragma_table_info(?) WHERE name = ?;";
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	sqlite3_bind_text(stmt, 1, tableName.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_text(stmt, 2, columnName.c_str(), -1, SQLITE_STATIC);
+
+	bool exists = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0;
+
+	sqlite3_finalize(stmt);
+	return exists;
+}
+
+// Databases from before the CATEGORIES table keep the category name on every row. It is moved into
+// CATEGORIES once and INVENTORY keeps only the id
+bool Database::MigrateCategories()
+{
+	if (!HasColumn("INVENTORY", "CATEGORY"))
+		return true;
+
+	if (!BeginTransaction("Category Migration"))
+		return false;
+
+	for (const char* SQL : {
+		"INSERT OR IGNORE INTO CATEGORIES (NAME) SELECT DISTINCT CATEGORY FROM INVENTORY ORDER BY CATEGORY;",
+		"ALTER TABLE INVENTORY ADD COLUMN CATEGORY_ID INTEGER REFERENCES CATEGORIES(ID);",
+		"UPDATE INVENTORY SET CATEGORY_ID = (SELECT ID FROM CATEGORIES WHERE NAME = INVENTORY.CATEGORY);",
+		"ALTER TABLE INVENTORY DROP COLUMN CATEGORY;" })
+	{
+		if (sqlite3_exec(db, SQL, nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			std::cerr << "\nCategory Migration Failed: " << sqlite3_errmsg(db) << '\n';
+			RollbackTransaction();
+			return false;
+		}
+	}
+
+	return CommitTransaction("Category Migration");
+}
+
+// A database created before sizes were normalised only has the SIZE text. The columns are added and every
+// existing size is parsed once, rows that do not parse stay SizeUnit::Unknown
+bool Database::MigrateItemSizes()
+{
+	if (HasColumn("INVENTORY", "SIZE_QUANTITY"))
+		return true;
+
+	if (!BeginTransaction("Size Migration"))
+		return false;
+
+	for (const char* SQL : {
+		"ALTER TABLE INVENTORY ADD COLUMN SIZE_QUANTITY INTEGER NOT NULL DEFAULT 0;",
+		"ALTER TABLE INVENTORY ADD COLUMN SIZE_UNIT INTEGER NOT NULL DEFAULT 0;" })
+	{
+		if (sqlite3_exec(db, SQL, nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			std::cerr << "\nSize Migration Failed: " << sqlite3_errmsg(db) << '\n';
+			RollbackTransaction();
+			return false;
+		}
+	}
+
+	sqlite3_stmt* select_stmt;
+	sqlite3_stmt* update_stmt;
+	if (sqlite3_prepare_v2(db, "SELECT ID, SIZE FROM INVENTORY;", -1, &select_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
+		return false;
+	}
+
+	if (sqlite3_prepare_v2(db, "UPDATE INVENTORY SET SIZE_QUANTITY = ?, SIZE_UNIT = ? WHERE ID = ?;", -1, &update_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		sqlite3_finalize(select_stmt);
+		RollbackTransaction();
+		return false;
+	}
+
+	bool migrated = true;
+	while (migrated && sqlite3_step(select_stmt) == SQLITE_ROW)
+	{
+		ItemSize size;
+		if (!ItemSize::Parse((const char*)sqlite3_column_text(select_stmt, 1), size))
+			continue;
+
+		sqlite3_bind_int64(update_stmt, 1, size.baseQuantity);
+		sqlite3_bind_int(update_stmt, 2, static_cast<int>(size.unit));
+		sqlite3_bind_int(update_stmt, 3, sqlite3_column_int(select_stmt, 0));
+
+		migrated = sqlite3_step(update_stmt) == SQLITE_DONE;
+		sqlite3_reset(update_stmt);
+	}
+
+	if (!migrated)
+		std::cerr << "\nSize Migration Failed: " << sqlite3_errmsg(db) << '\n';
+
+	sqlite3_finalize(update_stmt);
+	sqlite3_finalize(select_stmt);
+
+	if (!migrated)
+	{
+		RollbackTransaction();
+		return false;
+	}
+
+	return CommitTransaction("Size Migration");
+}
+
+// Returns the id of a category name, adding it to CATEGORIES the first time it is used
+bool Database::InternCategory(const std::string& name, int& categoryID)
+{
+	const char* SQL = "INSERT INTO CATEGORIES (NAME) VALUES (?) ON CONFLICT(NAME) DO UPDATE SET NAME = excluded.NAME RETURNING ID;";
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
+
+	int result = sqlite3_step(stmt);
+	if (result == SQLITE_ROW)
+		categoryID = sqlite3_column_int(stmt, 0);
+
+	sqlite3_finalize(stmt);
+
+	if (result == SQLITE_ROW)
+		return true;
+
+	std::cerr << "\nFailed to store category " << name << ": " << sqlite3_errmsg(db) << '\n';
+	return false;
+}
+
+// Full-text prefix search needs SQLite built with SQLITE_ENABLE_FTS5. INVENTORY_SEARCH indexes the names and
+// descriptions without a copy of them (content='INVENTORY') and the triggers keep it in step with INVENTORY.
+// Without FTS5 the triggers are dropped, since they would make every write fail, and the index is rebuilt
+// the next time a build with FTS5 opens the database. The trigram index is loaded either way
+bool Database::SetupSearch()
+{
+	const char* triggerNames[] = { "TRG_INVENTORY_SEARCH_INSERT", "TRG_INVENTORY_SEARCH_DELETE", "TRG_INVENTORY_SEARCH_UPDATE" };
+
+	fullTextSearch = sqlite3_compileoption_used("ENABLE_FTS5") == 1;
+	if (!fullTextSearch)
+	{
+		for (const char* triggerName : triggerNames)
+			sqlite3_exec(db, ("DROP TRIGGER IF EXISTS " + std::string(triggerName) + ";").c_str(), nullptr, nullptr, nullptr);
+	}
+	else
+	{
+		bool synced = true;
+		for (const char* triggerName : triggerNames)
+			synced = synced && HasTrigger(triggerName);
+
+		const char* SQL = "CREATE VIRTUAL TABLE IF NOT EXISTS INVENTORY_SEARCH USING fts5(PRODUCT_NAME, DESCRIPTION, "
+			"content='INVENTORY', content_rowid='ID', prefix='2 3');";
+		if (sqlite3_exec(db, SQL, nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			std::cerr << "\nFailed to create database table INVENTORY_SEARCH: " << sqlite3_errmsg(db) << '\n';
+			return false;
+		}
+
+		const std::string addRow = "INSERT INTO INVENTORY_SEARCH (rowid, PRODUCT_NAME, DESCRIPTION) VALUES (NEW.ID, NEW.PRODUCT_NAME, NEW.DESCRIPTION); ";
+		const std::string removeRow = "INSERT INTO INVENTORY_SEARCH (INVENTORY_SEARCH, rowid, PRODUCT_NAME, DESCRIPTION) VALUES ('delete', OLD.ID, OLD.PRODUCT_NAME, OLD.DESCRIPTION); ";
+
+		if (!CreateTrigger(triggerNames[0], "AFTER INSERT ON INVENTORY BEGIN " + addRow + "END")
+			|| !CreateTrigger(triggerNames[1], "AFTER DELETE ON INVENTORY BEGIN " + removeRow + "END")
+			|| !CreateTrigger(triggerNames[2], "AFTER UPDATE OF PRODUCT_NAME, DESCRIPTION ON INVENTORY BEGIN " + removeRow + addRow + "END"))
+		{
+			return false;
+		}
+
+		if (!synced && sqlite3_exec(db, "INSERT INTO INVENTORY_SEARCH (INVENTORY_SEARCH) VALUES ('rebuild');", nullptr, nullptr, nullptr) != SQLITE_OK)
+		{
+			std::cerr << "\nFailed to build the search index: " << sqlite3_errmsg(db) << '\n';
+			return false;
+		}
+	}
+
+	const char* SQL = "SELECT ID, PRODUCT_NAME FROM INVENTORY;";
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	nameTrigrams.Clear();
+	while (sqlite3_step(stmt) == SQLITE_ROW)
+	{
+		const char* name = (const char*)sqlite3_column_text(stmt, 1);
+		nameTrigrams.Add(sqlite3_column_int(stmt, 0), name ? name : "");
+	}
+
+	sqlite3_finalize(stmt);
+	return true;
+}
+
+bool Database::HasTrigger(const std::string& triggerName)
+{
+	const char* SQL = "SELECT count(*) FROM sqlite_master WHERE type = 'trigger' AND name = ?;";
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	sqlite3_bind_text(stmt, 1, triggerName.c_str(), -1, SQLITE_STATIC);
+
+	bool exists = sqlite3_step(stmt) == SQLITE_ROW && sqlite3_column_int(stmt, 0) > 0;
+
+	sqlite3_finalize(stmt);
+	return exists;
+}
+
+// Every stock change and its ledger rows are written in one BEGIN IMMEDIATE transaction
+bool Database::BeginTransaction(const char* action)
+{
+	if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) == SQLITE_OK)
+		return true;
+
+	std::cerr << '\n' << action << " Failed: " << sqlite3_errmsg(db) << '\n';
+	return false;
+}
+
+bool Database::CommitTransaction(const char* action)
+{
+	if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK)
+		return true;
+
+	std::cerr << '\n' << action << " Failed: " << sqlite3_errmsg(db) << '\n';
+	RollbackTransaction();
+	return false;
+}
+
+void Database::RollbackTransaction()
+{
+	sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+}
+
+sqlite3_stmt* Database::PrepareMovement()
+{
+	const char* SQL = "INSERT INTO STOCK_MOVEMENTS (ITEM_ID, DELTA, AMOUNT_AFTER, REASON) VALUES (?, ?, ?, ?);";
+	sqlite3_stmt* movement_stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &movement_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return nullptr;
+	}
+
+	return movement_stmt;
+}
+
+// Appends one row to STOCK_MOVEMENTS, the hourly and daily totals are rolled up by its trigger
+bool Database::RecordMovement(sqlite3_stmt* movement_stmt, int itemID, int delta, int amountAfter, const char* reason)
+{
+	sqlite3_bind_int(movement_stmt, 1, itemID);
+	sqlite3_bind_int(movement_stmt, 2, delta);
+	sqlite3_bind_int(movement_stmt, 3, amountAfter);
+	sqlite3_bind_text(movement_stmt, 4, reason, -1, SQLITE_STATIC);
+
+	int result = sqlite3_step(movement_stmt);
+	sqlite3_reset(movement_stmt);
+
+	if (result == SQLITE_DONE)
+		return true;
+
+	std::cerr << "\nFailed to record stock movement: " << sqlite3_errmsg(db) << '\n';
+	return false;
+}
+
+bool Database::RecordMovement(int itemID, int delta, int amountAfter, const char* reason)
+{
+	sqlite3_stmt* movement_stmt = PrepareMovement();
+	if (!movement_stmt)
+		return false;
+
+	bool recorded = RecordMovement(movement_stmt, itemID, delta, amountAfter, reason);
+	sqlite3_finalize(movement_stmt);
+	return recorded;
+}
+
 bool Database::ValidateUser(const std::string& username, const std::string& password)
 {
 	const char* SQL = "SELECT count(*) FROM USERS WHERE USERNAME = ? AND PASSWORD = ?";
@@ -128,7 +446,7 @@ bool Database::RemoveUser(const std::string& username, const std::string& passwo
 
 bool Database::ValidateItem(InventoryItem& object)
 {
-	const char* SQL = "SELECT CATEGORY, PRODUCT_NAME, AMOUNT, PRICE, SIZE, DESCRIPTION, CREATED_AT FROM INVENTORY WHERE PRODUCT_NAME = ?;";
+	const char* SQL = "SELECT C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE, I.SIZE, I.DESCRIPTION, I.CREATED_AT, I.ID FROM INVENTORY I LEFT JOIN CATEGORIES C ON C.ID = I.CATEGORY_ID WHERE I.PRODUCT_NAME = ?;";
 	sqlite3_stmt* validate_stmt;
 	if (sqlite3_prepare_v2(db, SQL, -1, &validate_stmt, nullptr) != SQLITE_OK)
 	{
@@ -154,6 +472,7 @@ bool Database::ValidateItem(InventoryItem& object)
 		object.size = size ? size : "0kg";
 		object.description = desc ? desc : "No Description";
 		object.createdAt = date ? date : "N/A";
+		object.id = sqlite3_column_int(validate_stmt, 7);
 		
 		productValidated = true;
 	}
@@ -164,100 +483,423 @@ bool Database::ValidateItem(InventoryItem& object)
 
 bool Database::ModifyItem(const std::string& originalProductName, const InventoryItem& object)
 {
-	const char* SQL = "UPDATE INVENTORY SET CATEGORY = ?, PRODUCT_NAME = ?, AMOUNT = ?, PRICE = ?, SIZE = ?, DESCRIPTION = ?, CREATED_AT = CURRENT_TIMESTAMP WHERE PRODUCT_NAME = ?;";
+	if (!BeginTransaction("Update"))
+		return false;
+
+	// The stock before the change, so a new amount can be written to the movement ledger
+	const char* findSQL = "SELECT ID, AMOUNT FROM INVENTORY WHERE PRODUCT_NAME = ?;";
+	sqlite3_stmt* find_stmt;
+	if (sqlite3_prepare_v2(db, findSQL, -1, &find_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
+		return false;
+	}
+
+	sqlite3_bind_text(find_stmt, 1, originalProductName.c_str(), -1, SQLITE_STATIC);
+
+	int itemID = 0, oldAmount = 0;
+	if (sqlite3_step(find_stmt) == SQLITE_ROW)
+	{
+		itemID = sqlite3_column_int(find_stmt, 0);
+		oldAmount = sqlite3_column_int(find_stmt, 1);
+	}
+
+	sqlite3_finalize(find_stmt);
+
+	if (itemID == 0)
+	{
+		std::cerr << "\nUpdate Failed: Product " << originalProductName << " Not Found!\n";
+		RollbackTransaction();
+		return false;
+	}
+
+	int categoryID;
+	if (!InternCategory(object.category, categoryID))
+	{
+		RollbackTransaction();
+		return false;
+	}
+
+	// Sizes that do not parse keep their text and are left out of the weight and volume totals
+	ItemSize size;
+	ItemSize::Parse(object.size.c_str(), size);
+
+	const char* SQL = "UPDATE INVENTORY SET CATEGORY_ID = ?, PRODUCT_NAME = ?, AMOUNT = ?, PRICE = ?, SIZE = ?, DESCRIPTION = ?, "
+		"SIZE_QUANTITY = ?, SIZE_UNIT = ?, CREATED_AT = CURRENT_TIMESTAMP WHERE ID = ?;";
 	sqlite3_stmt* update_stmt;
 	if (sqlite3_prepare_v2(db, SQL, -1, &update_stmt, nullptr) != SQLITE_OK)
 	{
 		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
 		return false;
 	}
 
-	sqlite3_bind_text(update_stmt, 1, object.category.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_int(update_stmt, 1, categoryID);
 	sqlite3_bind_text(update_stmt, 2, object.productName.c_str(), -1, SQLITE_STATIC);
 	sqlite3_bind_int(update_stmt, 3, object.amount);
 	sqlite3_bind_double(update_stmt, 4, object.price);
 	sqlite3_bind_text(update_stmt, 5, object.size.c_str(), -1, SQLITE_STATIC);
 	sqlite3_bind_text(update_stmt, 6, object.description.c_str(), -1, SQLITE_STATIC);
-	sqlite3_bind_text(update_stmt, 7, originalProductName.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_int64(update_stmt, 7, size.baseQuantity);
+	sqlite3_bind_int(update_stmt, 8, static_cast<int>(size.unit));
+	sqlite3_bind_int(update_stmt, 9, itemID);
 
 	int result = sqlite3_step(update_stmt);
 	sqlite3_finalize(update_stmt);
 
-	if (result == SQLITE_DONE)
+	if (result != SQLITE_DONE)
 	{
-		if (sqlite3_changes(db) > 0)
-			return true;
+		std::cerr << "\nUpdate Failed: Database Error -> " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
+		return false;
+	}
 
-		std::cerr << "\nUpdate Failed: Product " << originalProductName << " Not Found!\n";
+	if (object.amount != oldAmount && !RecordMovement(itemID, object.amount - oldAmount, object.amount, "modify"))
+	{
+		RollbackTransaction();
 		return false;
 	}
 
-	std::cerr << "\nUpdate Failed: Database Error -> " << sqlite3_errmsg(db) << '\n';
-	return false;
+	if (!CommitTransaction("Update"))
+		return false;
+
+	if (object.productName != originalProductName)
+	{
+		nameTrigrams.Remove(itemID, originalProductName);
+		nameTrigrams.Add(itemID, object.productName);
+	}
+
+	return true;
 }
 
 bool Database::InsertItem(const InventoryItem& object)
 {
-	const char* SQL = "INSERT INTO INVENTORY (CATEGORY, PRODUCT_NAME, AMOUNT, PRICE, SIZE, DESCRIPTION) VALUES (?, ?, ?, ?, ?, ?);";
+	if (!BeginTransaction("Add Product"))
+		return false;
+
+	int categoryID;
+	if (!InternCategory(object.category, categoryID))
+	{
+		RollbackTransaction();
+		return false;
+	}
+
+	ItemSize size;
+	ItemSize::Parse(object.size.c_str(), size);
+
+	const char* SQL = "INSERT INTO INVENTORY (CATEGORY_ID, PRODUCT_NAME, AMOUNT, PRICE, SIZE, DESCRIPTION, SIZE_QUANTITY, SIZE_UNIT) VALUES (?, ?, ?, ?, ?, ?, ?, ?);";
 	sqlite3_stmt* insert_stmt;
 	if (sqlite3_prepare_v2(db, SQL, -1, &insert_stmt, nullptr) != SQLITE_OK)
 	{
 		std::cerr << "\nError Preparing sqlite3_preprare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
 		return false;
 	}
 
-	sqlite3_bind_text(insert_stmt, 1, object.category.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_int(insert_stmt, 1, categoryID);
 	sqlite3_bind_text(insert_stmt, 2, object.productName.c_str(), -1, SQLITE_STATIC);
 	sqlite3_bind_int(insert_stmt, 3, object.amount);
 	sqlite3_bind_double(insert_stmt, 4, object.price);
 	sqlite3_bind_text(insert_stmt, 5, object.size.c_str(), -1, SQLITE_STATIC);
 	sqlite3_bind_text(insert_stmt, 6, object.description.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_int64(insert_stmt, 7, size.baseQuantity);
+	sqlite3_bind_int(insert_stmt, 8, static_cast<int>(size.unit));
 
 	int result = sqlite3_step(insert_stmt);
 	sqlite3_finalize(insert_stmt);
 
 	if (result == SQLITE_DONE)
+	{
+		int itemID = static_cast<int>(sqlite3_last_insert_rowid(db));
+		if (object.amount != 0 && !RecordMovement(itemID, object.amount, object.amount, "created"))
+		{
+			RollbackTransaction();
+			return false;
+		}
+
+		if (!CommitTransaction("Add Product"))
+			return false;
+
+		nameTrigrams.Add(itemID, object.productName);
 		return true;
+	}
 
 	if (result == SQLITE_CONSTRAINT)
 		std::cerr << "\nFailed to add product to inventory: Product arleady exists!\n";
 	else
 		std::cerr << "\nFailed to add product to inventory: " << sqlite3_errmsg(db) << '\n';
 
+	RollbackTransaction();
 	return false;
 }
 
 bool Database::RemoveItem(const std::string& productName)
 {
-	const char* SQL = "DELETE FROM INVENTORY WHERE PRODUCT_NAME = ?;";
+	if (!BeginTransaction("Remove Product"))
+		return false;
+
+	const char* SQL = "DELETE FROM INVENTORY WHERE PRODUCT_NAME = ? RETURNING ID, AMOUNT;";
 	sqlite3_stmt* delete_stmt;
 	if (sqlite3_prepare_v2(db, SQL, -1, &delete_stmt, nullptr) != SQLITE_OK)
 	{
 		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
 		return false;
 	}
 
 	sqlite3_bind_text(delete_stmt, 1, productName.c_str(), -1, SQLITE_STATIC);
 
+	int itemID = 0, amount = 0;
 	int result = sqlite3_step(delete_stmt);
+	if (result == SQLITE_ROW)
+	{
+		itemID = sqlite3_column_int(delete_stmt, 0);
+		amount = sqlite3_column_int(delete_stmt, 1);
+	}
+
 	sqlite3_finalize(delete_stmt);
 
-	if (result == SQLITE_DONE)
+	if (result == SQLITE_ROW)
 	{
-		if (sqlite3_changes(db) > 0)
-			return true;
+		// The stock that left with the product is the last movement of its ledger
+		if (amount != 0 && !RecordMovement(itemID, -amount, 0, "removed"))
+		{
+			RollbackTransaction();
+			return false;
+		}
+
+		if (!CommitTransaction("Remove Product"))
+			return false;
 
+		nameTrigrams.Remove(itemID, productName);
+		return true;
+	}
+
+	if (result == SQLITE_DONE)
 		std::cerr << "\nFailed to remove product from the inventory. Please try again!\n";
+	else
+		std::cerr << "\nDatabase Error During Removing Product: " << sqlite3_errmsg(db) << '\n';
+
+	RollbackTransaction();
+	return false;
+}
+
+bool Database::AdjustStock(int itemID, int delta, int& newAmount)
+{
+	std::vector<StockAdjustment> adjustments{ { itemID, delta } };
+	if (!AdjustStock(adjustments))
+		return false;
+
+	newAmount = adjustments[0].newAmount;
+	return true;
+}
+
+bool Database::AdjustStock(std::vector<StockAdjustment>& adjustments)
+{
+	for (StockAdjustment& adjustment : adjustments)
+		adjustment.applied = false;
+
+	if (!BeginTransaction("Stock Update"))
+		return false;
+
+	// Only AMOUNT is touched, and the check against going below zero happens in the same statement
+	const char* SQL = "UPDATE INVENTORY SET AMOUNT = AMOUNT + ?1 WHERE ID = ?2 AND AMOUNT + ?1 >= 0 RETURNING AMOUNT;";
+	sqlite3_stmt* adjust_stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &adjust_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
 		return false;
 	}
 
-	std::cerr << "\nDatabase Error During Removing Product: " << sqlite3_errmsg(db) << '\n';
-	return false;
+	sqlite3_stmt* movement_stmt = PrepareMovement();
+	if (!movement_stmt)
+	{
+		sqlite3_finalize(adjust_stmt);
+		RollbackTransaction();
+		return false;
+	}
+
+	// One statement is reused for every line, the whole basket is applied or none of it
+	bool success = true;
+	for (StockAdjustment& adjustment : adjustments)
+	{
+		sqlite3_bind_int(adjust_stmt, 1, adjustment.delta);
+		sqlite3_bind_int(adjust_stmt, 2, adjustment.itemID);
+
+		int result = sqlite3_step(adjust_stmt);
+		if (result == SQLITE_ROW)
+		{
+			adjustment.newAmount = sqlite3_column_int(adjust_stmt, 0);
+			adjustment.applied = true;
+
+			success = RecordMovement(movement_stmt, adjustment.itemID, adjustment.delta, adjustment.newAmount, "adjust");
+		}
+		else
+		{
+			if (result == SQLITE_DONE)
+				std::cerr << "\nStock Update Failed: Item " << adjustment.itemID << " Not Found Or Not Enough Stock!\n";
+			else
+				std::cerr << "\nStock Update Failed: Database Error -> " << sqlite3_errmsg(db) << '\n';
+
+			success = false;
+		}
+
+		sqlite3_reset(adjust_stmt);
+
+		if (!success)
+			break;
+	}
+
+	sqlite3_finalize(adjust_stmt);
+	sqlite3_finalize(movement_stmt);
+
+	if (success)
+		success = CommitTransaction("Stock Update");
+	else
+		RollbackTransaction();
+
+	if (!success)
+	{
+
+		for (StockAdjustment& adjustment : adjustments)
+			adjustment.applied = false;
+	}
+
+	return success;
+}
+
+bool Database::Checkout(Order& order)
+{
+	order.total = 0.0;
+	for (OrderLine& line : order.lines)
+		line.status = OrderLineStatus::Pending;
+
+	if (order.lines.empty())
+		return false;
+
+	if (!BeginTransaction("Checkout"))
+		return false;
+
+	// Validating and taking the stock is one statement per line, reused for the whole order
+	const char* SQL = "UPDATE INVENTORY SET AMOUNT = AMOUNT - ?1 WHERE PRODUCT_NAME = ?2 AND AMOUNT >= ?1 RETURNING ID, PRICE, AMOUNT;";
+	sqlite3_stmt* sell_stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &sell_stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		RollbackTransaction();
+		return false;
+	}
+
+	sqlite3_stmt* movement_stmt = PrepareMovement();
+	if (!movement_stmt)
+	{
+		sqlite3_finalize(sell_stmt);
+		RollbackTransaction();
+		return false;
+	}
+
+	// Only needed to tell a missing product from a short one, so it is prepared on the first failed line
+	sqlite3_stmt* find_stmt = nullptr;
+
+	bool success = true;
+	bool databaseError = false;
+	for (OrderLine& line : order.lines)
+	{
+		if (line.quantity <= 0)
+		{
+			line.status = OrderLineStatus::InvalidQuantity;
+			success = false;
+			continue;
+		}
+
+		sqlite3_bind_int(sell_stmt, 1, line.quantity);
+		sqlite3_bind_text(sell_stmt, 2, line.productName.c_str(), -1, SQLITE_STATIC);
+
+		int result = sqlite3_step(sell_stmt);
+		if (result == SQLITE_ROW)
+		{
+			line.itemID = sqlite3_column_int(sell_stmt, 0);
+			line.price = sqlite3_column_double(sell_stmt, 1);
+			line.remaining = sqlite3_column_int(sell_stmt, 2);
+			line.status = OrderLineStatus::Sold;
+
+			order.total += line.price * line.quantity;
+
+			if (!RecordMovement(movement_stmt, line.itemID, -line.quantity, line.remaining, "sale"))
+			{
+				success = false;
+				databaseError = true;
+			}
+		}
+		else if (result == SQLITE_DONE)
+		{
+			success = false;
+			line.status = OrderLineStatus::NotFound;
+
+			if (!find_stmt && sqlite3_prepare_v2(db, "SELECT ID, PRICE, AMOUNT FROM INVENTORY WHERE PRODUCT_NAME = ?;", -1, &find_stmt, nullptr) != SQLITE_OK)
+			{
+				std::cerr << "\nError Preparing sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+				find_stmt = nullptr;
+				databaseError = true;
+			}
+
+			if (find_stmt)
+			{
+				sqlite3_bind_text(find_stmt, 1, line.productName.c_str(), -1, SQLITE_STATIC);
+
+				if (sqlite3_step(find_stmt) == SQLITE_ROW)
+				{
+					line.itemID = sqlite3_column_int(find_stmt, 0);
+					line.price = sqlite3_column_double(find_stmt, 1);
+					line.remaining = sqlite3_column_int(find_stmt, 2);
+					line.status = OrderLineStatus::OutOfStock;
+				}
+
+				sqlite3_reset(find_stmt);
+			}
+		}
+		else
+		{
+			std::cerr << "\nCheckout Failed: Database Error -> " << sqlite3_errmsg(db) << '\n';
+			success = false;
+			databaseError = true;
+		}
+
+		sqlite3_reset(sell_stmt);
+
+		if (databaseError)
+			break;
+	}
+
+	sqlite3_finalize(sell_stmt);
+	sqlite3_finalize(find_stmt);
+	sqlite3_finalize(movement_stmt);
+
+	if (success)
+		success = CommitTransaction("Checkout");
+	else
+		RollbackTransaction();
+
+	// A single bad line cancels the whole order. Every line was still checked so all problems can be shown at once,
+	// the lines that were fine go back to Pending
+	if (!success)
+	{
+		order.total = 0.0;
+
+		for (OrderLine& line : order.lines)
+			if (line.status == OrderLineStatus::Sold)
+				line.status = OrderLineStatus::Pending;
+	}
+
+	return success;
 }
 
 bool Database::GetItem(InventoryItem& object)
 {
-	const char* SQL = "SELECT CATEGORY, PRODUCT_NAME, AMOUNT, PRICE, SIZE, DESCRIPTION, CREATED_AT FROM INVENTORY WHERE CATEGORY = ? AND PRODUCT_NAME = ?;";
+	const char* SQL = "SELECT C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE, I.SIZE, I.DESCRIPTION, I.CREATED_AT, I.ID FROM CATEGORIES C "
+		"JOIN INVENTORY I ON I.CATEGORY_ID = C.ID AND I.PRODUCT_NAME = ?2 WHERE C.NAME = ?1;";
 	sqlite3_stmt* stmt;
 	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
 	{
@@ -282,6 +924,7 @@ bool Database::GetItem(InventoryItem& object)
 		object.size = size ? size : "0kg";
 		object.description = desc ? desc : "No Description";
 		object.createdAt = date ? date : "N/A";
+		object.id = sqlite3_column_int(stmt, 7);
 
 		exists = true;
 	}
@@ -294,39 +937,337 @@ bool Database::GetItem(InventoryItem& object)
 	return exists;
 }
 
-std::vector<InventoryItem> Database::GetAllItems()
+// One page of the whole inventory in cursor.order, ties broken by ID. Every page starts right after the cursor's
+// row in the index of the sort column, so it costs the same however deep into the listing it is. Rows are handed
+// to the visitor as they are stepped instead of being copied, returns the number of rows or -1 on an error
+int Database::GetItemsPage(ItemCursor& cursor, int pageSize, const InventoryRowVisitor& visitor)
+{
+	const char* sortColumn = cursor.order == ItemSortOrder::Price ? "I.PRICE"
+		: cursor.order == ItemSortOrder::Amount ? "I.AMOUNT"
+		: cursor.order == ItemSortOrder::Created ? "I.CREATED_AT" : "I.PRODUCT_NAME";
+
+	std::string SQL = "SELECT C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE, I.SIZE, I.DESCRIPTION, I.CREATED_AT, I.ID "
+		"FROM INVENTORY I LEFT JOIN CATEGORIES C ON C.ID = I.CATEGORY_ID ";
+
+	if (!cursor.atStart)
+		SQL += "WHERE (" + std::string(sortColumn) + ", I.ID) > (?2, ?3) ";
+
+	SQL += "ORDER BY " + std::string(sortColumn) + ", I.ID LIMIT ?1;";
+
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nFailed to fetch items: " << sqlite3_errmsg(db) << '\n';
+		return -1;
+	}
+
+	sqlite3_bind_int(stmt, 1, pageSize);
+	if (!cursor.atStart)
+	{
+		// Copied, the cursor moves on while the statement is still stepping
+		if (cursor.order == ItemSortOrder::Name || cursor.order == ItemSortOrder::Created)
+			sqlite3_bind_text(stmt, 2, cursor.lastText.c_str(), -1, SQLITE_TRANSIENT);
+		else
+			sqlite3_bind_double(stmt, 2, cursor.lastNumber);
+
+		sqlite3_bind_int(stmt, 3, cursor.lastID);
+	}
+
+	int rows{ 0 };
+	int rc;
+	while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+	{
+		const char* cat = (const char*)sqlite3_column_text(stmt, 0);
+		const char* name = (const char*)sqlite3_column_text(stmt, 1);
+		const char* size = (const char*)sqlite3_column_text(stmt, 4);
+		const char* desc = (const char*)sqlite3_column_text(stmt, 5);
+		const char* date = (const char*)sqlite3_column_text(stmt, 6);
+
+		InventoryRow row{
+			cat ? cat : "Unknown",
+			name ? name : "Unknown",
+			sqlite3_column_int(stmt, 2),
+			sqlite3_column_double(stmt, 3),
+			size ? size : "0kg",
+			desc ? desc : "No Description",
+			date ? date : "N/A",
+			sqlite3_column_int(stmt, 7)
+		};
+
+		visitor(row);
+		rows++;
+
+		// Assigned into the same strings every row, so their capacity is reused
+		if (cursor.order == ItemSortOrder::Name)
+			cursor.lastText = name ? name : "";
+		else if (cursor.order == ItemSortOrder::Created)
+			cursor.lastText = date ? date : "";
+		else
+			cursor.lastNumber = sqlite3_column_double(stmt, cursor.order == ItemSortOrder::Price ? 3 : 2);
+
+		cursor.lastID = row.id;
+		cursor.atStart = false;
+	}
+
+	if (rc != SQLITE_DONE)
+	{
+		std::cerr << "\nFailed to fetch items: " << sqlite3_errmsg(db) << '\n';
+		rows = -1;
+	}
+
+	sqlite3_finalize(stmt);
+	return rows;
+}
+
+// One page of a category in PRODUCT_NAME order, read from the IDX_INVENTORY_CATEGORY range of that category only.
+// The cursor is moved to the last row returned, a page shorter than pageSize is the last one
+std::vector<InventoryItem> Database::GetItemsByCategory(const std::string& category, CategoryCursor& cursor, int pageSize)
 {
 	std::vector<InventoryItem> storedItems;
 
-	const char* SQL = "SELECT CATEGORY, PRODUCT_NAME, AMOUNT, PRICE, SIZE, DESCRIPTION, CREATED_AT FROM INVENTORY;";
+	const char* firstPageSQL = "SELECT C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE, I.SIZE, I.DESCRIPTION, I.CREATED_AT, I.ID FROM CATEGORIES C "
+		"JOIN INVENTORY I ON I.CATEGORY_ID = C.ID WHERE C.NAME = ?1 ORDER BY I.PRODUCT_NAME LIMIT ?2;";
+	const char* nextPageSQL = "SELECT C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE, I.SIZE, I.DESCRIPTION, I.CREATED_AT, I.ID FROM CATEGORIES C "
+		"JOIN INVENTORY I ON I.CATEGORY_ID = C.ID WHERE C.NAME = ?1 AND I.PRODUCT_NAME > ?3 ORDER BY I.PRODUCT_NAME LIMIT ?2;";
+
 	sqlite3_stmt* stmt;
-	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) == SQLITE_OK)
+	if (sqlite3_prepare_v2(db, cursor.atStart ? firstPageSQL : nextPageSQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nFailed to fetch items: " << sqlite3_errmsg(db) << '\n';
+		return storedItems;
+	}
+
+	sqlite3_bind_text(stmt, 1, category.c_str(), -1, SQLITE_STATIC);
+	sqlite3_bind_int(stmt, 2, pageSize);
+	if (!cursor.atStart)
+		sqlite3_bind_text(stmt, 3, cursor.productName.c_str(), -1, SQLITE_STATIC);
+
+	while (sqlite3_step(stmt) == SQLITE_ROW)
+	{
+		InventoryItem item;
+
+		const char* cat = (const char*)sqlite3_column_text(stmt, 0);
+		const char* name = (const char*)sqlite3_column_text(stmt, 1);
+		const char* size = (const char*)sqlite3_column_text(stmt, 4);
+		const char* desc = (const char*)sqlite3_column_text(stmt, 5);
+		const char* date = (const char*)sqlite3_column_text(stmt, 6);
+
+		item.category = cat ? cat : "Unknown";
+		item.productName = name ? name : "Unknown";
+		item.amount = sqlite3_column_int(stmt, 2);
+		item.price = sqlite3_column_double(stmt, 3);
+		item.size = size ? size : "0kg";
+		item.description = desc ? desc : "No Description";
+		item.createdAt = date ? date : "N/A";
+		item.id = sqlite3_column_int(stmt, 7);
+
+		storedItems.push_back(item);
+	}
+
+	sqlite3_finalize(stmt);
+
+	// The bound name above points into the cursor, so it only moves once the statement is done
+	if (!storedItems.empty())
 	{
+		cursor.atStart = false;
+		cursor.productName = storedItems.back().productName;
+	}
+
+	return storedItems;
+}
+
+// Up to limit products for what an operator typed. Every word is first matched as a prefix of the name or
+// description words (FTS5, names weigh ten times more). Remaining places are filled with names that look like
+// the query (trigram index), which catches typos the prefix search cannot. A category keeps both passes inside it
+std::vector<SearchResult> Database::SearchItems(const std::string& query, int limit, const std::string& category)
+{
+	std::vector<SearchResult> results;
+	if (limit <= 0)
+		return results;
+
+	auto readResult = [](sqlite3_stmt* stmt, SearchResult& result) {
+		const char* cat = (const char*)sqlite3_column_text(stmt, 1);
+		const char* name = (const char*)sqlite3_column_text(stmt, 2);
+
+		result.itemID = sqlite3_column_int(stmt, 0);
+		result.category = cat ? cat : "Unknown";
+		result.productName = name ? name : "Unknown";
+		result.amount = sqlite3_column_int(stmt, 3);
+		result.price = sqlite3_column_double(stmt, 4);
+	};
+
+	// "hot so" becomes "hot"* "so"*, quoting keeps FTS5 operators typed by the operator from being parsed
+	std::string matchQuery;
+	std::string word;
+	for (size_t i = 0; i <= query.size(); i++)
+	{
+		if (i < query.size() && std::isalnum(static_cast<unsigned char>(query[i])))
+		{
+			word += query[i];
+		}
+		else if (!word.empty())
+		{
+			matchQuery += (matchQuery.empty() ? "\"" : " \"") + word + "\"*";
+			word.clear();
+		}
+	}
+
+	if (fullTextSearch && !matchQuery.empty())
+	{
+		const char* SQL = "SELECT I.ID, C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE FROM INVENTORY_SEARCH S "
+			"JOIN INVENTORY I ON I.ID = S.rowid LEFT JOIN CATEGORIES C ON C.ID = I.CATEGORY_ID "
+			"WHERE INVENTORY_SEARCH MATCH ?1 AND (?3 = '' OR C.NAME = ?3) ORDER BY bm25(INVENTORY_SEARCH, 10.0, 1.0) LIMIT ?2;";
+
+		sqlite3_stmt* stmt;
+		if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+		{
+			std::cerr << "\nFailed to search items: " << sqlite3_errmsg(db) << '\n';
+			return results;
+		}
+
+		sqlite3_bind_text(stmt, 1, matchQuery.c_str(), -1, SQLITE_STATIC);
+		sqlite3_bind_int(stmt, 2, limit);
+		sqlite3_bind_text(stmt, 3, category.c_str(), -1, SQLITE_STATIC);
+
 		while (sqlite3_step(stmt) == SQLITE_ROW)
 		{
-			InventoryItem item;
-
-			const char* cat = (const char*)sqlite3_column_text(stmt, 0);
-			const char* name = (const char*)sqlite3_column_text(stmt, 1);
-			const char* size = (const char*)sqlite3_column_text(stmt, 4);
-			const char* desc = (const char*)sqlite3_column_text(stmt, 5);
-			const char* date = (const char*)sqlite3_column_text(stmt, 6);
-
-			item.category = cat ? cat : "Unknown";
-			item.productName = name ? name : "Unknown";
-			item.amount = sqlite3_column_int(stmt, 2);
-			item.price = sqlite3_column_double(stmt, 3);
-			item.size = size ? size : "0kg";
-			item.description = desc ? desc : "No Description";
-			item.createdAt = date ? date : "N/A";
-
-			storedItems.push_back(item);
+			SearchResult result;
+			readResult(stmt, result);
+			results.push_back(result);
 		}
+
+		sqlite3_finalize(stmt);
 	}
-	else {
-		std::cerr << "\nFailed to fetch items: " << sqlite3_errmsg(db) << '\n';
+
+	if (static_cast<int>(results.size()) >= limit)
+		return results;
+
+	// Similar names, skipping the ones the prefix search already returned. Inside a category every similar name is
+	// taken, since the closest ones may all be in other categories
+	size_t candidates = category.empty() ? static_cast<size_t>(limit) + results.size() : std::numeric_limits<size_t>::max();
+	std::vector<std::pair<int, double>> matches = nameTrigrams.Search(query, candidates);
+	if (matches.empty())
+		return results;
+
+	const char* SQL = "SELECT I.ID, C.NAME, I.PRODUCT_NAME, I.AMOUNT, I.PRICE FROM INVENTORY I "
+		"LEFT JOIN CATEGORIES C ON C.ID = I.CATEGORY_ID WHERE I.ID = ?1 AND (?2 = '' OR C.NAME = ?2);";
+
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nFailed to search items: " << sqlite3_errmsg(db) << '\n';
+		return results;
+	}
+
+	sqlite3_bind_text(stmt, 2, category.c_str(), -1, SQLITE_STATIC);
+
+	size_t prefixMatches = results.size();
+	for (const std::pair<int, double>& match : matches)
+	{
+		if (static_cast<int>(results.size()) >= limit)
+			break;
+
+		bool found = false;
+		for (size_t i = 0; i < prefixMatches; i++)
+			found = found || results[i].itemID == match.first;
+
+		if (found)
+			continue;
+
+		sqlite3_bind_int(stmt, 1, match.first);
+		if (sqlite3_step(stmt) == SQLITE_ROW)
+		{
+			SearchResult result;
+			readResult(stmt, result);
+			result.similar = true;
+			results.push_back(result);
+		}
+
+		sqlite3_reset(stmt);
 	}
 
 	sqlite3_finalize(stmt);
-	return storedItems;
+	return results;
+}
+
+// Stock on hand per category: size times amount summed over the weights (grams) and the volumes (millilitres).
+// Items whose size could not be read are only counted
+std::vector<CategorySizeTotals> Database::GetSizeTotals()
+{
+	std::vector<CategorySizeTotals> totals;
+
+	const char* SQL = "SELECT C.NAME, "
+		"SUM(CASE WHEN I.SIZE_UNIT BETWEEN ?1 AND ?2 THEN I.SIZE_QUANTITY * I.AMOUNT ELSE 0 END), "
+		"SUM(CASE WHEN I.SIZE_UNIT BETWEEN ?3 AND ?4 THEN I.SIZE_QUANTITY * I.AMOUNT ELSE 0 END), "
+		"SUM(I.SIZE_UNIT = ?5) "
+		"FROM INVENTORY I LEFT JOIN CATEGORIES C ON C.ID = I.CATEGORY_ID GROUP BY I.CATEGORY_ID ORDER BY C.NAME;";
+
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nFailed to fetch size totals: " << sqlite3_errmsg(db) << '\n';
+		return totals;
+	}
+
+	sqlite3_bind_int(stmt, 1, static_cast<int>(SizeUnit::Grams));
+	sqlite3_bind_int(stmt, 2, static_cast<int>(SizeUnit::Tonnes));
+	sqlite3_bind_int(stmt, 3, static_cast<int>(SizeUnit::Millilitres));
+	sqlite3_bind_int(stmt, 4, static_cast<int>(SizeUnit::Litres));
+	sqlite3_bind_int(stmt, 5, static_cast<int>(SizeUnit::Unknown));
+
+	while (sqlite3_step(stmt) == SQLITE_ROW)
+	{
+		const char* cat = (const char*)sqlite3_column_text(stmt, 0);
+
+		CategorySizeTotals total;
+		total.category = cat ? cat : "Unknown";
+		total.grams = sqlite3_column_int64(stmt, 1);
+		total.millilitres = sqlite3_column_int64(stmt, 2);
+		total.unsized = sqlite3_column_int(stmt, 3);
+		totals.push_back(total);
+	}
+
+	sqlite3_finalize(stmt);
+	return totals;
+}
+
+// Reads the rolled up totals of one item for the last few hours or days, oldest first, without touching STOCK_MOVEMENTS
+std::vector<StockMovementTotals> Database::GetMovementTotals(int itemID, bool hourly, int periods)
+{
+	std::vector<StockMovementTotals> totals;
+
+	const char* hourlySQL = "SELECT HOUR, UNITS_IN, UNITS_OUT, UNITS_SOLD, MOVEMENTS FROM STOCK_MOVEMENTS_HOURLY "
+		"WHERE ITEM_ID = ? AND HOUR >= strftime('%Y-%m-%d %H:00', 'now', ?) ORDER BY HOUR;";
+	const char* dailySQL = "SELECT DAY, UNITS_IN, UNITS_OUT, UNITS_SOLD, MOVEMENTS FROM STOCK_MOVEMENTS_DAILY "
+		"WHERE ITEM_ID = ? AND DAY >= date('now', ?) ORDER BY DAY;";
+
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, hourly ? hourlySQL : dailySQL, -1, &stmt, nullptr) != SQLITE_OK)
+	{
+		std::cerr << "\nFailed to fetch stock movements: " << sqlite3_errmsg(db) << '\n';
+		return totals;
+	}
+
+	std::string since = "-" + std::to_string(periods > 0 ? periods - 1 : 0) + (hourly ? " hours" : " days");
+
+	sqlite3_bind_int(stmt, 1, itemID);
+	sqlite3_bind_text(stmt, 2, since.c_str(), -1, SQLITE_STATIC);
+
+	while (sqlite3_step(stmt) == SQLITE_ROW)
+	{
+		StockMovementTotals period;
+
+		const char* start = (const char*)sqlite3_column_text(stmt, 0);
+
+		period.period = start ? start : "N/A";
+		period.unitsIn = sqlite3_column_int(stmt, 1);
+		period.unitsOut = sqlite3_column_int(stmt, 2);
+		period.unitsSold = sqlite3_column_int(stmt, 3);
+		period.movements = sqlite3_column_int(stmt, 4);
+
+		totals.push_back(period);
+	}
+
+	sqlite3_finalize(stmt);
+	return totals;
 }
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cstdio>
 #include "InvManager.h"
 
 bool InventoryManager::setup_inventory_manager(Database& db, AuthManager& auth)
@@ -20,7 +21,7 @@ bool InventoryManager::setup_inventory_manager(Database& db, AuthManager& auth)
 			continue;
 		}
 
-		if (userInput < 1 || userInput > 10)
+		if (userInput < 1 || userInput > 14)
 		{
 			std::cout << "\nInvalid Number!\n";
 			std::cout << "\nPress Enter To Continue . . .";
@@ -64,11 +65,27 @@ bool InventoryManager::setup_inventory_manager(Database& db, AuthManager& auth)
 			InventoryManager::DeleteItem(db);
 		}
 		else if (userInput == 9)
+		{
+			InventoryManager::AdjustItemStock(db);
+		}
+		else if (userInput == 10)
+		{
+			InventoryManager::CheckoutOrder(db);
+		}
+		else if (userInput == 11)
+		{
+			InventoryManager::StockMovementReport(db);
+		}
+		else if (userInput == 12)
+		{
+			InventoryManager::SizeTotalsReport(db);
+		}
+		else if (userInput == 13)
 		{
 			InventoryManager::LogUserOut(auth);
 			return true;
 		}
-		else if (userInput == 10)
+		else if (userInput == 14)
 		{
 			std::cout << "\nExiting Program . . .\n";
 			break;
@@ -81,12 +98,37 @@ bool InventoryManager::setup_inventory_manager(Database& db, AuthManager& auth)
 void InventoryManager::SelectItem(const char* itemCategory, Database& db)
 {
 	system("cls");
-	InventoryItem storedItem{ itemCategory };
+	InventoryItem storedItem{};
+	storedItem.category = itemCategory;
+	CategoryCursor cursor;
 
-	std::cout << "Item Name: ";
-	std::getline(std::cin >> std::ws, storedItem.productName);
+	std::cout << "**** " << itemCategory << " ****\n";
+	dbUtils::ClearInputBuffer();
+
+	// The category is listed a page at a time until an item is picked
+	while (true)
+	{
+		std::vector<InventoryItem> page = db.GetItemsByCategory(itemCategory, cursor, pageSize);
+		for (const InventoryItem& item : page)
+			std::cout << item.productName << " - " << item.amount << "x - $" << item.price << '\n';
+
+		if (page.empty() && cursor.atStart)
+			std::cout << "No Items Found In This Category\n";
+
+		bool lastPage = static_cast<int>(page.size()) < pageSize;
+
+		std::cout << (lastPage ? "\nItem Name: " : "\nItem Name (Enter = next page): ");
+		std::getline(std::cin, storedItem.productName);
+
+		if (!storedItem.productName.empty())
+			break;
+
+		if (lastPage)
+			return;
+	}
 	
-	if (!(db.GetItem(storedItem)))
+	// Suggestions come from the chosen category only, GetItem then reads the picked one within it
+	if (!(db.GetItem(storedItem)) && !(PickFromSearch(db, storedItem.productName, storedItem.category) && db.GetItem(storedItem)))
 	{
 		std::cout << "\nPress Enter To Continue . . .";
 		std::cin.get();
@@ -108,33 +150,78 @@ void InventoryManager::SelectItem(const char* itemCategory, Database& db)
 void InventoryManager::DisplayItems(Database& db)
 {
 	system("cls");
+	ItemCursor cursor;
+	int userInput;
 
-	std::vector<InventoryItem> storedItems = db.GetAllItems();
-	if (storedItems.empty())
+	std::cout << "**** Sort Items By ****\n";
+	std::cout << "1 = Name\n";
+	std::cout << "2 = Price\n";
+	std::cout << "3 = Amount\n";
+	std::cout << "4 = Created At\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> userInput) || userInput < 1 || userInput > 4)
 	{
-		std::cout << "\nNo Items Found In Inventory!\n";
+		std::cout << "\nInvalid Input\n";
+		std::cout << "\nPress Enter To Continue . . .";
+
+		dbUtils::ClearInputBuffer();
+		std::cin.get();
+
+		return;
 	}
-	else {
-		int count{ 0 };
 
-		for (const InventoryItem& item : storedItems)
-		{
-			count++;
-
-			std::cout << "**** Item " << count << " ****\n";
-			std::cout << "Category: " << item.category << '\n';
-			std::cout << "Name: " << item.productName << '\n';
-			std::cout << "Amount: " << item.amount << "x\n";
-			std::cout << "Price: $" << item.price << '\n';
-			std::cout << "Size: " << item.size << "\n";
-			std::cout << "Description: " << item.description << '\n';
-			std::cout << "Created At: " << item.createdAt << '\n';
-			std::cout << "---------------------------------------\n\n";
-		}
+	dbUtils::ClearInputBuffer();
+	cursor.order = static_cast<ItemSortOrder>(userInput - 1);
+
+	// Every page is written into the same buffer straight from the row and printed at once, nothing else is kept
+	std::string page;
+	char price[32];
+	int count{ 0 };
+
+	auto render = [&](const InventoryRow& item) {
+		count++;
+		std::snprintf(price, sizeof(price), "%g", item.price);
+
+		page += "**** Item ";
+		page += std::to_string(count);
+		page += " ****\nCategory: ";
+		page += item.category;
+		page += "\nName: ";
+		page += item.productName;
+		page += "\nAmount: ";
+		page += std::to_string(item.amount);
+		page += "x\nPrice: $";
+		page += price;
+		page += "\nSize: ";
+		page += item.size;
+		page += "\nDescription: ";
+		page += item.description;
+		page += "\nCreated At: ";
+		page += item.createdAt;
+		page += "\n---------------------------------------\n\n";
+	};
+
+	while (true)
+	{
+		page.clear();
+		int rows = db.GetItemsPage(cursor, pageSize, render);
+		std::cout << page;
+
+		if (count == 0 && rows == 0)
+			std::cout << "\nNo Items Found In Inventory!\n";
+
+		if (rows < pageSize)
+			break;
+
+		std::string next;
+		std::cout << "Enter = Next Page, 0 = Back: ";
+		std::getline(std::cin, next);
+
+		if (!next.empty())
+			return;
 	}
 
 	std::cout << "\nPress Enter To Continue . . .";
-	dbUtils::ClearInputBuffer();
 	std::cin.get();
 }
 
@@ -147,7 +234,7 @@ void InventoryManager::UpdateItem(Database& db)
 	std::cout << "Item Name: ";
 	std::getline(std::cin >> std::ws, original_object.productName);
 	
-	if (!db.ValidateItem(original_object)) {
+	if (!FindItem(db, original_object)) {
 		std::cout << "\nItem Not Found\n";
 		std::cout << "\nPress Enter To Continue . . .";
 
@@ -179,7 +266,9 @@ void InventoryManager::UpdateItem(Database& db)
 		if (!(invUtils::get_product_price(object.price)))
 			continue;
 
-		invUtils::get_product_size(object.size);
+		if (!(invUtils::get_product_size(object.size)))
+			continue;
+
 		invUtils::get_product_description(object.description);
 
 		if (!object.category.empty() && !object.productName.empty() && object.amount > 0 && object.price > 0 && !object.size.empty() && !object.description.empty())
@@ -235,12 +324,14 @@ void InventoryManager::AddItem(Database& db)
 		if (!(invUtils::get_product_price(price)))
 			continue;
 
-		invUtils::get_product_size(itemSize);
+		if (!(invUtils::get_product_size(itemSize)))
+			continue;
+
 		invUtils::get_product_description(itemDesc);
 
 		if (!itemCategory.empty() && !itemName.empty() && amount > 0 && price > 0 && !itemSize.empty() && !itemDesc.empty())
 		{
-			InventoryItem object{ itemCategory, itemName, amount, price, itemSize, itemDesc };
+			InventoryItem object{ itemCategory, itemName, amount, price, itemSize, itemDesc, {} };
 			db.InsertItem(object);
 			break;
 		}
@@ -250,16 +341,252 @@ void InventoryManager::AddItem(Database& db)
 void InventoryManager::DeleteItem(Database& db)
 {
 	system("cls");
-	std::string productName;
+	InventoryItem object;
+
+	std::cout << "Item Name: ";
+	std::getline(std::cin >> std::ws, object.productName);
+
+	if (!FindItem(db, object)) { std::cout << "\nItem Not Found\n"; }
+	else if (db.RemoveItem(object.productName)) { std::cout << "\nItem Deleted Successfully\n"; }
+	std::cout << "\nPress Enter To Continue . . .";
+	std::cin.get();
+}
+
+void InventoryManager::AdjustItemStock(Database& db)
+{
+	system("cls");
+	InventoryItem object;
+	int delta;
 
 	std::cout << "Item Name: ";
-	std::getline(std::cin >> std::ws, productName);
+	std::getline(std::cin >> std::ws, object.productName);
+
+	if (!FindItem(db, object))
+	{
+		std::cout << "\nItem Not Found\n";
+		std::cout << "\nPress Enter To Continue . . .";
+		std::cin.get();
+
+		return;
+	}
+
+	std::cout << "In Stock: " << object.amount << "x\n";
+	std::cout << "Stock Change (e.g. -3 sold, 10 delivered): ";
+	if (!(std::cin >> delta))
+	{
+		std::cout << "\nInvalid Input\n";
+		std::cout << "\nPress Enter To Continue . . .";
+
+		dbUtils::ClearInputBuffer();
+		std::cin.get();
+
+		return;
+	}
+
+	int newAmount;
+	if (db.AdjustStock(object.id, delta, newAmount))
+		std::cout << "\nStock Updated: " << object.amount << "x ---> " << newAmount << "x\n";
 
-	if (db.RemoveItem(productName)) { std::cout << "\nItem Deleted Successfully\n"; }
 	std::cout << "\nPress Enter To Continue . . .";
+	dbUtils::ClearInputBuffer();
 	std::cin.get();
 }
 
+void InventoryManager::CheckoutOrder(Database& db)
+{
+	system("cls");
+	Order order;
+
+	std::cout << "**** Checkout Order ****\n";
+	std::cout << "Enter each item of the order, leave the name empty to finish\n";
+	dbUtils::ClearInputBuffer();
+
+	while (true)
+	{
+		OrderLine line{};
+
+		std::cout << "\nItem Name: ";
+		std::getline(std::cin, line.productName);
+		if (line.productName.empty())
+			break;
+
+		std::cout << "Quantity: ";
+		if (!(std::cin >> line.quantity))
+		{
+			std::cout << "\nInvalid Input\n";
+			dbUtils::ClearInputBuffer();
+
+			continue;
+		}
+
+		dbUtils::ClearInputBuffer();
+		order.lines.push_back(line);
+	}
+
+	if (order.lines.empty())
+	{
+		std::cout << "\nNo Items Entered\n";
+		std::cout << "\nPress Enter To Continue . . .";
+		std::cin.get();
+
+		return;
+	}
+
+	bool sold = db.Checkout(order);
+
+	std::cout << "\n**** " << (sold ? "Order Completed" : "Order Cancelled") << " ****\n";
+	for (const OrderLine& line : order.lines)
+	{
+		std::cout << line.quantity << "x " << line.productName << " - ";
+
+		if (line.status == OrderLineStatus::Sold)
+			std::cout << "$" << line.price * line.quantity << " (" << line.remaining << "x left)\n";
+		else if (line.status == OrderLineStatus::NotFound)
+			std::cout << "Item Not Found\n";
+		else if (line.status == OrderLineStatus::OutOfStock)
+			std::cout << "Not Enough Stock (" << line.remaining << "x left)\n";
+		else if (line.status == OrderLineStatus::InvalidQuantity)
+			std::cout << "Invalid Quantity\n";
+		else
+			std::cout << "OK\n";
+	}
+
+	if (sold)
+		std::cout << "---------------------------------------\nTotal: $" << order.total << '\n';
+	else
+		std::cout << "\nNo stock was taken, fix the lines above and enter the order again\n";
+
+	std::cout << "\nPress Enter To Continue . . .";
+	std::cin.get();
+}
+
+void InventoryManager::StockMovementReport(Database& db)
+{
+	system("cls");
+	InventoryItem object;
+	int userInput;
+
+	std::cout << "Item Name: ";
+	std::getline(std::cin >> std::ws, object.productName);
+
+	if (!FindItem(db, object))
+	{
+		std::cout << "\nItem Not Found\n";
+		std::cout << "\nPress Enter To Continue . . .";
+		std::cin.get();
+
+		return;
+	}
+
+	std::cout << "\n1 = Last 24 Hours (per hour)\n";
+	std::cout << "2 = Last 30 Days (per day)\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> userInput) || (userInput != 1 && userInput != 2))
+	{
+		std::cout << "\nInvalid Input\n";
+		std::cout << "\nPress Enter To Continue . . .";
+
+		dbUtils::ClearInputBuffer();
+		std::cin.get();
+
+		return;
+	}
+
+	bool hourly = userInput == 1;
+	std::vector<StockMovementTotals> totals = db.GetMovementTotals(object.id, hourly, hourly ? 24 : 30);
+
+	std::cout << "\n**** " << object.productName << " Stock Movements ****\n";
+	if (totals.empty())
+	{
+		std::cout << "No Stock Movements In This Period\n";
+	}
+	else {
+		int sold{ 0 }, used{ 0 }, added{ 0 };
+
+		for (const StockMovementTotals& period : totals)
+		{
+			std::cout << period.period << "  Sold: " << period.unitsSold << "x  Out: " << period.unitsOut << "x  In: " << period.unitsIn << "x\n";
+
+			sold += period.unitsSold;
+			used += period.unitsOut;
+			added += period.unitsIn;
+		}
+
+		std::cout << "---------------------------------------\n";
+		std::cout << "Total  Sold: " << sold << "x  Out: " << used << "x  In: " << added << "x\n";
+		std::cout << "Sold Per " << (hourly ? "Hour" : "Day") << ": " << sold / (hourly ? 24.0 : 30.0) << "x\n";
+	}
+
+	std::cout << "In Stock: " << object.amount << "x\n";
+
+	std::cout << "\nPress Enter To Continue . . .";
+	dbUtils::ClearInputBuffer();
+	std::cin.get();
+}
+
+void InventoryManager::SizeTotalsReport(Database& db)
+{
+	system("cls");
+
+	std::vector<CategorySizeTotals> totals = db.GetSizeTotals();
+
+	std::cout << "**** Stock Weight & Volume ****\n";
+	if (totals.empty())
+		std::cout << "\nNo Items Found In Inventory!\n";
+
+	for (const CategorySizeTotals& total : totals)
+	{
+		std::cout << total.category << ": " << ItemSize{ total.grams, SizeUnit::Kilograms }.Format()
+			<< " - " << ItemSize{ total.millilitres, SizeUnit::Litres }.Format();
+
+		if (total.unsized > 0)
+			std::cout << " (" << total.unsized << " item(s) without a known size)";
+
+		std::cout << '\n';
+	}
+
+	std::cout << "\nPress Enter To Continue . . .";
+	dbUtils::ClearInputBuffer();
+	std::cin.get();
+}
+
+// Lists the products closest to productName, only those in category when one is given, and replaces it with
+// the one picked, false if none was
+bool InventoryManager::PickFromSearch(Database& db, std::string& productName, const std::string& category)
+{
+	std::vector<SearchResult> results = db.SearchItems(productName, searchLimit, category);
+	if (results.empty())
+		return false;
+
+	std::cout << "\nDid You Mean:\n";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		std::cout << i + 1 << ". " << results[i].productName << " (" << results[i].category << ") - "
+			<< results[i].amount << "x - $" << results[i].price << (results[i].similar ? " ~" : "") << '\n';
+	}
+
+	int choice;
+	std::cout << "\nNumber (0 = None): ";
+	if (!(std::cin >> choice) || choice < 1 || choice > static_cast<int>(results.size()))
+	{
+		dbUtils::ClearInputBuffer();
+		return false;
+	}
+
+	dbUtils::ClearInputBuffer();
+	productName = results[choice - 1].productName;
+	return true;
+}
+
+// Exact name first, the search suggestions when nothing is called that
+bool InventoryManager::FindItem(Database& db, InventoryItem& object)
+{
+	if (db.ValidateItem(object))
+		return true;
+
+	return PickFromSearch(db, object.productName) && db.ValidateItem(object);
+}
+
 void InventoryManager::LogUserOut(AuthManager& auth)
 {
 	std::string user = auth.get_current_user();
@@ -9,6 +9,12 @@
 
 class InventoryManager
 {
+private:
+	static constexpr int pageSize{ 20 }; // Items shown per page when browsing a category or the whole inventory
+	static constexpr int searchLimit{ 10 }; // Suggestions offered when a typed name does not match exactly
+
+	bool PickFromSearch(Database& db, std::string& productName, const std::string& category = "");
+	bool FindItem(Database& db, InventoryItem& object);
 public:
 	InventoryManager() {};
 	~InventoryManager() {};
@@ -20,5 +26,9 @@ public:
 	void UpdateItem(Database& db);
 	void AddItem(Database& db);
 	void DeleteItem(Database& db);
+	void AdjustItemStock(Database& db);
+	void CheckoutOrder(Database& db);
+	void StockMovementReport(Database& db);
+	void SizeTotalsReport(Database& db);
 	void LogUserOut(AuthManager& auth);
 };
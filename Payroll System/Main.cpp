@@ -16,6 +16,9 @@ int main() {
 	if (!db.SetupTables())
 		return 1;
 
+	payroll.loadTaxTables("tax_tables.csv"); // Falls back to a flat 15% tax when the file is missing
+	payroll.loadPayRules("pay_rules.csv");   // Falls back to overtime after 8h/day or 40h/week at 1.5x
+
 	while (true) {
 		if (!auth.getLoggedInStatus()) {
 			if (!auth.setupRegistration()) { break; }
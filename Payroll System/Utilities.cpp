@@ -1,4 +1,5 @@
 #include <iostream>
+#include <cctype>
 #include "Utilities.h"
 
 // ----- //
@@ -17,8 +18,14 @@ void Utils::Pause() {
 	std::cin.get();
 }
 
-void Utils::formatDate(std::string& date) {
-	date = date.substr(6, 4) + "-" + date.substr(3, 2) + "-" + date.substr(0, 2);
+// Returns false when the user chooses to stop paging through a listing //
+bool Utils::NextPage() {
+	std::cout << "-- Press Enter for the next page, or type q to stop -- ";
+
+	std::string input;
+	std::getline(std::cin, input);
+
+	return input.empty() || std::tolower(static_cast<unsigned char>(input[0])) != 'q';
 }
 
 // ------- //
@@ -36,3 +43,119 @@ bool dbUtils::CreateTable(sqlite3* db, const std::string& tableName, const std::
 
 	return true;
 }
+
+bool dbUtils::CreateIndex(sqlite3* db, const std::string& indexName, const std::string& tableName, const std::string& columns) {
+	std::string SQL = "CREATE INDEX IF NOT EXISTS " + indexName + " ON " + tableName + " (" + columns + ");";
+
+	int response = sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr);
+	if (response != SQLITE_OK) {
+		std::cerr << "\nFailed to create index " << indexName << ": " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	return true;
+}
+
+bool dbUtils::CreateTrigger(sqlite3* db, const std::string& triggerName, const std::string& event, const std::string& body) {
+	std::string SQL = "CREATE TRIGGER IF NOT EXISTS " + triggerName + " " + event + " BEGIN " + body + " END;";
+
+	int response = sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr);
+	if (response != SQLITE_OK) {
+		std::cerr << "\nFailed to create trigger " << triggerName << ": " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	return true;
+}
+
+bool dbUtils::HasColumn(sqlite3* db, const std::string& tableName, const std::string& columnName) {
+	std::string infoSQL = "SELECT 1 FROM pragma_table_info('" + tableName + "') WHERE name = ?;";
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, infoSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+		std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	sqlite3_bind_text(stmt, 1, columnName.c_str(), -1, SQLITE_STATIC);
+	bool exists = sqlite3_step(stmt) == SQLITE_ROW;
+	sqlite3_finalize(stmt);
+
+	return exists;
+}
+
+// Adds a column to tables created by an older version of the program //
+bool dbUtils::AddColumn(sqlite3* db, const std::string& tableName, const std::string& columnName, const std::string& definition) {
+	if (HasColumn(db, tableName, columnName))
+		return true;
+
+	std::string SQL = "ALTER TABLE " + tableName + " ADD COLUMN " + columnName + " " + definition + ";";
+	if (sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+		std::cerr << "\nFailed to add column " << columnName << " to " << tableName << ": " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	return true;
+}
+
+// Rewrites 'YYYY-MM-DD' text values left by older versions as days since 1970-01-01.    //
+// Text that is not a date is listed and nothing is rewritten, so it can be fixed by hand //
+bool dbUtils::ConvertDateColumn(sqlite3* db, const std::string& tableName, const std::string& columnName) {
+	std::string checkSQL = "SELECT rowid, " + columnName + " FROM " + tableName + " "
+		"WHERE typeof(" + columnName + ") = 'text' AND julianday(" + columnName + ") IS NULL;";
+
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, checkSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+		std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	int invalidRows{ 0 };
+	while (sqlite3_step(stmt) == SQLITE_ROW) {
+		const char* value = (const char*)sqlite3_column_text(stmt, 1);
+
+		if (invalidRows++ == 0)
+			std::cerr << "\nCannot convert " << tableName << "." << columnName << " to integer dates, these rows are not dates:\n";
+
+		std::cerr << "  rowid " << sqlite3_column_int64(stmt, 0) << ": '" << (value ? value : "") << "'\n";
+	}
+
+	sqlite3_finalize(stmt);
+
+	if (invalidRows > 0)
+		return false;
+
+	std::string SQL = "UPDATE " + tableName + " SET " + columnName + " = "
+		"CAST(julianday(" + columnName + ") - 2440587.5 AS INTEGER) "
+		"WHERE typeof(" + columnName + ") = 'text';";
+
+	if (sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+		std::cerr << "\nFailed to convert " << tableName << "." << columnName << " to integer dates: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	return true;
+}
+
+int dbUtils::GetSchemaVersion(sqlite3* db) {
+	sqlite3_stmt* stmt;
+	if (sqlite3_prepare_v2(db, "PRAGMA user_version;", -1, &stmt, nullptr) != SQLITE_OK) {
+		std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+		return 0;
+	}
+
+	int version = sqlite3_step(stmt) == SQLITE_ROW ? sqlite3_column_int(stmt, 0) : 0;
+	sqlite3_finalize(stmt);
+
+	return version;
+}
+
+bool dbUtils::SetSchemaVersion(sqlite3* db, int version) {
+	std::string SQL = "PRAGMA user_version = " + std::to_string(version) + ";";
+
+	if (sqlite3_exec(db, SQL.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+		std::cerr << "\nFailed to set schema version: " << sqlite3_errmsg(db) << '\n';
+		return false;
+	}
+
+	return true;
+}
@@ -7,9 +7,16 @@
 namespace Utils {
 	void ClearInputBuffer();
 	void Pause();
-	void formatDate(std::string& date);
+	bool NextPage();
 }
 
 namespace dbUtils {
 	bool CreateTable(sqlite3* db, const std::string& tableName, const std::string& columns);
+	bool CreateIndex(sqlite3* db, const std::string& indexName, const std::string& tableName, const std::string& columns);
+	bool CreateTrigger(sqlite3* db, const std::string& triggerName, const std::string& event, const std::string& body);
+	bool HasColumn(sqlite3* db, const std::string& tableName, const std::string& columnName);
+	bool AddColumn(sqlite3* db, const std::string& tableName, const std::string& columnName, const std::string& definition);
+	bool ConvertDateColumn(sqlite3* db, const std::string& tableName, const std::string& columnName);
+	int GetSchemaVersion(sqlite3* db);
+	bool SetSchemaVersion(sqlite3* db, int version);
 }
@@ -0,0 +1,363 @@
+// Payroll benchmark: generates a seeded synthetic workforce with a year of time entries and  //
+// pay periods, times the Database operations the program uses and prints the results as JSON //
+//                                                                                            //
+// Usage: PayrollBenchmark [--employees N] [--seed S] [--year Y] [--db file] [--output file]  //
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+#include "../database/Database.h"
+#include "../tax/TaxEngine.h"
+#include "../reports/PayStubGenerator.h"
+
+struct BenchmarkResult {
+	std::string name;
+	long long operations;
+	double seconds;
+};
+
+struct BenchmarkOptions {
+	int employees{ 1000 };
+	unsigned int seed{ 42 };
+	int year{ 2025 };
+	int addTimeEntrySample{ 2000 }; // Entries inserted one by one, the rest go through the bulk importer
+	std::string databaseFile{ "payroll_benchmark.db" };
+	std::string outputFile;
+};
+
+class Stopwatch
+{
+private:
+	std::chrono::steady_clock::time_point start{ std::chrono::steady_clock::now() };
+public:
+	double seconds() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
+static bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string flag = argv[i];
+		std::string value = argv[i + 1];
+
+		try {
+			if (flag == "--employees") options.employees = std::stoi(value);
+			else if (flag == "--seed") options.seed = static_cast<unsigned int>(std::stoul(value));
+			else if (flag == "--year") options.year = std::stoi(value);
+			else if (flag == "--db") options.databaseFile = value;
+			else if (flag == "--output") options.outputFile = value;
+			else return false;
+		}
+		catch (const std::exception&) {
+			return false;
+		}
+	}
+
+	return (argc % 2 == 1) && options.employees > 0;
+}
+
+static std::string toJson(const BenchmarkOptions& options, long long timeEntries, int payPeriods, const std::vector<BenchmarkResult>& results) {
+	std::ostringstream json;
+	json.precision(6);
+	json << std::fixed;
+
+	json << "{\n";
+	json << "  \"seed\": " << options.seed << ",\n";
+	json << "  \"employees\": " << options.employees << ",\n";
+	json << "  \"time_entries\": " << timeEntries << ",\n";
+	json << "  \"pay_periods\": " << payPeriods << ",\n";
+	json << "  \"results\": [\n";
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const BenchmarkResult& result = results[i];
+		double perSecond = result.seconds > 0.0 ? result.operations / result.seconds : 0.0;
+
+		json << "    { \"name\": \"" << result.name << "\", "
+			<< "\"operations\": " << result.operations << ", "
+			<< "\"seconds\": " << result.seconds << ", "
+			<< "\"ops_per_second\": " << perSecond << " }"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+
+	json << "  ]\n";
+	json << "}\n";
+
+	return json.str();
+}
+
+int main(int argc, char* argv[]) {
+	BenchmarkOptions options;
+	if (!parseOptions(argc, argv, options)) {
+		std::cerr << "Usage: PayrollBenchmark [--employees N] [--seed S] [--year Y] [--db file] [--output file]\n";
+		return 1;
+	}
+
+	std::remove(options.databaseFile.c_str());
+
+	Database db;
+	if (!db.openDatabase(options.databaseFile) || !db.SetupTables())
+		return 1;
+
+	db.setConsoleWaitTimer(0);
+
+	TaxEngine taxEngine;
+	taxEngine.loadFromFile("tax_tables.csv");
+
+	PayRules payRules;
+	payRules.loadFromFile("pay_rules.csv");
+
+	// Progress output of the payroll run would dominate the timings, so stdout is muted while measuring //
+	std::ostringstream mutedOutput;
+	std::streambuf* originalOutput = std::cout.rdbuf(mutedOutput.rdbuf());
+
+	std::mt19937 random(options.seed);
+	std::vector<BenchmarkResult> results;
+
+	const std::vector<std::string> departments = { "Kitchen", "Front of House", "Warehouse", "Delivery", "Finance", "HR", "IT", "Cleaning" };
+	const std::vector<std::string> employmentTypes = { "full-time", "part-time", "contractor" };
+	const std::vector<std::string> jurisdictions = { "US-FED", "DEFAULT" };
+	const std::vector<std::string> filingStatuses = { "single", "married" };
+	const std::vector<std::string> names = { "Alex", "Sam", "Jordan", "Taylor", "Morgan", "Casey", "Riley", "Jamie", "Avery", "Quinn" };
+
+	// --------- //
+	// Employees //
+	// --------- //
+
+	std::uniform_int_distribution<int> pickName(0, static_cast<int>(names.size()) - 1);
+	std::uniform_int_distribution<int> pickDepartment(0, static_cast<int>(departments.size()) - 1);
+	std::uniform_int_distribution<int> pickType(0, static_cast<int>(employmentTypes.size()) - 1);
+	std::uniform_int_distribution<int> pickCoin(0, 1);
+	std::uniform_int_distribution<int> pickRateCents(1500, 6000);
+	std::uniform_int_distribution<int> pickHireOffset(0, 3650);
+
+	Date yearStart = Date::fromCivil(options.year, 1, 1);
+	Date yearEnd = Date::fromCivil(options.year, 12, 31);
+
+	Stopwatch employeeTimer;
+	for (int i = 0; i < options.employees; i++) {
+		Employee emp;
+		emp.firstName = names[pickName(random)];
+		emp.lastName = names[pickName(random)] + "son" + std::to_string(i);
+		if (!db.internDepartment(departments[pickDepartment(random)], emp.departmentID)
+			|| !db.internEmploymentType(employmentTypes[pickType(random)], emp.employmentTypeID))
+			return 1;
+		emp.jurisdiction = jurisdictions[pickCoin(random)];
+		emp.filingStatus = filingStatuses[pickCoin(random)];
+		emp.hireDate.days = yearStart.days - pickHireOffset(random);
+		emp.hourlyRate = pickRateCents(random) / 100.0;
+		emp.isActive = true;
+
+		if (!db.addEmployee(emp))
+			return 1;
+	}
+	results.push_back({ "addEmployee", options.employees, employeeTimer.seconds() });
+
+	// Every employee pays into a pension, about half have a health plan and one in twenty a garnishment //
+	std::uniform_int_distribution<int> pickGarnishment(0, 19);
+	long long deductionCount{ 0 };
+
+	Stopwatch deductionTimer;
+	for (int employeeID = 1; employeeID <= options.employees; employeeID++) {
+		Deduction pension;
+		pension.employeeID = employeeID;
+		pension.kind = "pension";
+		pension.name = "Pension";
+		pension.preTax = true;
+		pension.percent = 5.0;
+
+		Deduction health;
+		health.employeeID = employeeID;
+		health.kind = "health";
+		health.name = "Health Plan";
+		health.amount = 45.0;
+
+		Deduction garnishment;
+		garnishment.employeeID = employeeID;
+		garnishment.kind = "garnishment";
+		garnishment.name = "Court Order";
+		garnishment.percent = 10.0;
+		garnishment.periodCap = 150.0;
+		garnishment.totalCap = 1200.0;
+
+		if (!db.addDeduction(pension))
+			return 1;
+		deductionCount++;
+
+		if (pickCoin(random) == 1) {
+			if (!db.addDeduction(health))
+				return 1;
+			deductionCount++;
+		}
+
+		if (pickGarnishment(random) == 0) {
+			if (!db.addDeduction(garnishment))
+				return 1;
+			deductionCount++;
+		}
+	}
+	results.push_back({ "addDeduction", deductionCount, deductionTimer.seconds() });
+
+	// ------------------------------------------------------------------- //
+	// A year of weekday time entries, written to a time-clock export file //
+	// ------------------------------------------------------------------- //
+
+	std::uniform_int_distribution<int> pickQuarterHours(16, 40); // 4h - 10h
+	std::uniform_int_distribution<int> pickAbsence(0, 19);       // ~5% of weekdays missed
+
+	std::vector<TimeEntry> sampleEntries;
+	std::string exportFile = options.databaseFile + ".punches.csv";
+	std::ofstream punches(exportFile, std::ios::binary);
+	long long timeEntries{ 0 };
+
+	for (int day = yearStart.days; day <= yearEnd.days; day++) {
+		Date dateWorked{ day };
+		if (dateWorked.weekday() == 0 || dateWorked.weekday() == 6)
+			continue;
+
+		char date[11];
+		dateWorked.format(date);
+
+		for (int employeeID = 1; employeeID <= options.employees; employeeID++) {
+			if (pickAbsence(random) == 0)
+				continue;
+
+			double hoursWorked = pickQuarterHours(random) / 4.0;
+			timeEntries++;
+
+			if (static_cast<int>(sampleEntries.size()) < options.addTimeEntrySample)
+				sampleEntries.push_back({ employeeID, dateWorked, hoursWorked });
+			else
+				punches << employeeID << ',' << date << ',' << hoursWorked << '\n';
+		}
+	}
+	punches.close();
+
+	Stopwatch addTimeEntryTimer;
+	for (const TimeEntry& entry : sampleEntries) {
+		if (!db.addTimeEntry(entry))
+			return 1;
+	}
+	results.push_back({ "addTimeEntry", static_cast<long long>(sampleEntries.size()), addTimeEntryTimer.seconds() });
+
+	ImportSummary summary;
+	Stopwatch importTimer;
+	if (!db.importTimeEntries(exportFile, false, exportFile + ".rejected", summary))
+		return 1;
+	results.push_back({ "importTimeEntries", summary.imported, importTimer.seconds() });
+	std::remove(exportFile.c_str());
+
+	// ------------------------------------------------------ //
+	// Biweekly pay periods covering the year, then payroll   //
+	// ------------------------------------------------------ //
+
+	int payPeriods{ 0 };
+	for (int start = yearStart.days; start + 13 <= yearEnd.days; start += 14) {
+		if (!db.addPayPeriod(Date{ start }, Date{ start + 13 }))
+			return 1;
+
+		payPeriods++;
+	}
+
+	Stopwatch singleRunTimer;
+	if (!db.insertPayrollForPayPeriod(1, taxEngine, payRules))
+		return 1;
+	results.push_back({ "insertPayrollForPayPeriod", options.employees, singleRunTimer.seconds() });
+
+	int periodsProcessed{ 0 }, recordsWritten{ 0 };
+	Stopwatch catchUpTimer;
+	if (!db.processOpenPayPeriods(taxEngine, payRules, periodsProcessed, recordsWritten))
+		return 1;
+	results.push_back({ "processOpenPayPeriods", recordsWritten, catchUpTimer.seconds() });
+
+	// ---------------------------------------------- //
+	// Listing queries, paged through to the last row //
+	// ---------------------------------------------- //
+
+	const int listingPageSize = 500;
+	long long rowsRead{ 0 };
+	int rowCount;
+
+	Stopwatch employeesTimer;
+	EmployeeCursor employeeCursor;
+	do {
+		rowCount = db.getEmployeesPage(employeeCursor, listingPageSize, [](const Employee&) { return true; });
+		rowsRead += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == listingPageSize);
+	results.push_back({ "getEmployeesPage", rowsRead, employeesTimer.seconds() });
+
+	rowsRead = 0;
+	Stopwatch timeEntriesTimer;
+	TimeEntryCursor timeEntryCursor;
+	do {
+		rowCount = db.getTimeEntriesPage(timeEntryCursor, listingPageSize, [](const TimeEntry&) { return true; });
+		rowsRead += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == listingPageSize);
+	results.push_back({ "getTimeEntriesPage", rowsRead, timeEntriesTimer.seconds() });
+
+	rowsRead = 0;
+	Stopwatch payrollTimer;
+	PayrollCursor payrollCursor;
+	do {
+		rowCount = db.getPayrollRecordsPage(payrollCursor, listingPageSize, [](const Payroll&) { return true; });
+		rowsRead += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == listingPageSize);
+	results.push_back({ "getPayrollRecordsPage", rowsRead, payrollTimer.seconds() });
+
+	rowsRead = 0;
+	Stopwatch historyTimer;
+	for (int employeeID = 1; employeeID <= options.employees; employeeID++) {
+		EmployeePayrollCursor historyCursor;
+		do {
+			rowCount = db.getEmployeePayrollHistoryPage(employeeID, historyCursor, listingPageSize, [](const EmployeePayroll&) { return true; });
+			rowsRead += rowCount > 0 ? rowCount : 0;
+		} while (rowCount == listingPageSize);
+	}
+	results.push_back({ "getEmployeePayrollHistoryPage", rowsRead, historyTimer.seconds() });
+
+	PayrollYtd ytd;
+	Stopwatch ytdTimer;
+	for (int employeeID = 1; employeeID <= options.employees; employeeID++)
+		db.getPayrollYtd(employeeID, options.year, ytd);
+	results.push_back({ "getPayrollYtd", options.employees, ytdTimer.seconds() });
+
+	// ----------------------------------------------- //
+	// Pay stubs for the last period, archive and files //
+	// ----------------------------------------------- //
+
+	PayStubGenerator stubGenerator(db.getDepartments());
+	int stubCount;
+
+	std::string archiveFile = options.databaseFile + ".stubs.txt";
+	Stopwatch archiveTimer;
+	if (!stubGenerator.generate(db, payPeriods, PayStubGenerator::Output::Archive, archiveFile, stubCount))
+		return 1;
+	results.push_back({ "generatePayStubs (archive)", stubCount, archiveTimer.seconds() });
+	std::remove(archiveFile.c_str());
+
+	std::string stubDirectory = options.databaseFile + ".stubs";
+	Stopwatch directoryTimer;
+	if (!stubGenerator.generate(db, payPeriods, PayStubGenerator::Output::Directory, stubDirectory, stubCount))
+		return 1;
+	results.push_back({ "generatePayStubs (directory)", stubCount, directoryTimer.seconds() });
+	std::filesystem::remove_all(stubDirectory);
+
+	std::cout.rdbuf(originalOutput);
+
+	std::string json = toJson(options, timeEntries, payPeriods, results);
+	if (options.outputFile.empty()) {
+		std::cout << json;
+	}
+	else {
+		std::ofstream output(options.outputFile);
+		output << json;
+	}
+
+	return 0;
+}
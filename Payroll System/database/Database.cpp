@@ -1,7 +1,12 @@
 #include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
 #include "Database.h"
+#include "../import/TimeClockReader.h"
+#include "../payroll/PayCalculator.h"
 
-Database::Database() : db{ nullptr } {}
+Database::Database() : db{ nullptr }, consoleWaitTimer{ 500 }, payrollChunkSize{ 500 } {}
 
 Database::~Database() {
 	if (db) {
@@ -17,36 +22,59 @@ bool Database::openDatabase(const std::string& fileName) {
 		return false;
 	}
 
+    databaseFile = fileName;
+
     sqlite3_exec(db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
+
+    // Write-ahead logging: reads (reports, simulations) run on a snapshot without blocking data entry //
+    sqlite3_exec(db, "PRAGMA journal_mode = WAL;", nullptr, nullptr, nullptr);
 	return true;
 }
 
+// Pause between progress messages of the interactive payroll run (0 disables it) //
+void Database::setConsoleWaitTimer(int milliseconds) {
+    consoleWaitTimer = milliseconds;
+}
+
+// Employees written per transaction by insertPayrollForPayPeriod //
+void Database::setPayrollChunkSize(int employees) {
+    payrollChunkSize = employees > 0 ? static_cast<size_t>(employees) : 1;
+}
+
 bool Database::SetupTables() {
     std::string employee_column =
         "id INTEGER PRIMARY KEY, "
         "first_name TEXT NOT NULL, "
         "last_name TEXT NOT NULL, "
-        "department TEXT, "
-        "employment_type TEXT, "
+        "department_id INTEGER REFERENCES departments(id), "
+        "employment_type_id INTEGER REFERENCES employment_types(id), "
         "hourly_rate REAL NOT NULL, "
-        "hire_date DATE NOT NULL, "
-        "is_active INTEGER DEFAULT 1";
+        "hire_date INTEGER NOT NULL, "
+        "is_active INTEGER DEFAULT 1, "
+        "jurisdiction TEXT NOT NULL DEFAULT 'DEFAULT', "
+        "filing_status TEXT NOT NULL DEFAULT 'single'";
+
+    // Lookup tables for values shared by many employees //
+    std::string lookup_column =
+        "id INTEGER PRIMARY KEY, "
+        "name TEXT NOT NULL UNIQUE";
 
     std::string time_entries_column =
         "id INTEGER PRIMARY KEY, "
         "employee_id INTEGER NOT NULL, "
-        "date_worked DATE NOT NULL, "
+        "date_worked INTEGER NOT NULL, "
         "hours_worked REAL NOT NULL, "
+        "shift_start INTEGER, "
         "UNIQUE(employee_id, date_worked), "
         "FOREIGN KEY(employee_id) REFERENCES employees(id) ON DELETE CASCADE";
 
     std::string pay_periods_column =
         "id INTEGER PRIMARY KEY, "
-        "start_date DATE NOT NULL, "
-        "end_date DATE NOT NULL, "
+        "start_date INTEGER NOT NULL, "
+        "end_date INTEGER NOT NULL, "
         "created_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
         "processed_at DATETIME, "
-        "CHECK(start_date < end_date)";
+        "CHECK(start_date <= end_date)";
 
     std::string payroll_column =
         "id INTEGER PRIMARY KEY, "
@@ -54,10 +82,89 @@ bool Database::SetupTables() {
         "pay_period_id INTEGER NOT NULL, "
         "gross_pay REAL NOT NULL, "
         "net_pay REAL NOT NULL, "
+        "tax REAL NOT NULL DEFAULT 0, "
+        "hours_worked REAL NOT NULL DEFAULT 0, "
         "UNIQUE(employee_id, pay_period_id), "
         "FOREIGN KEY(employee_id) REFERENCES employees(id) ON DELETE CASCADE, "
         "FOREIGN KEY(pay_period_id) REFERENCES pay_periods(id) ON DELETE CASCADE";
 
+    std::string payroll_ytd_column =
+        "employee_id INTEGER NOT NULL, "
+        "year INTEGER NOT NULL, "
+        "gross_pay REAL NOT NULL DEFAULT 0, "
+        "net_pay REAL NOT NULL DEFAULT 0, "
+        "tax REAL NOT NULL DEFAULT 0, "
+        "hours_worked REAL NOT NULL DEFAULT 0, "
+        "PRIMARY KEY(employee_id, year), "
+        "FOREIGN KEY(employee_id) REFERENCES employees(id) ON DELETE CASCADE";
+
+    // Labor cost per department and pay period, rewritten whenever a period's payroll changes //
+    std::string payroll_department_totals_column =
+        "pay_period_id INTEGER NOT NULL, "
+        "department_id INTEGER NOT NULL, "
+        "employee_count INTEGER NOT NULL DEFAULT 0, "
+        "hours_worked REAL NOT NULL DEFAULT 0, "
+        "gross_pay REAL NOT NULL DEFAULT 0, "
+        "tax REAL NOT NULL DEFAULT 0, "
+        "net_pay REAL NOT NULL DEFAULT 0, "
+        "PRIMARY KEY(pay_period_id, department_id), "
+        "FOREIGN KEY(pay_period_id) REFERENCES pay_periods(id) ON DELETE CASCADE";
+
+    // Progress of a payroll run that has committed some chunks but not finished the period //
+    std::string payroll_runs_column =
+        "pay_period_id INTEGER PRIMARY KEY, "
+        "last_employee_id INTEGER NOT NULL, "
+        "employees_done INTEGER NOT NULL DEFAULT 0, "
+        "started_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
+        "updated_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
+        "FOREIGN KEY(pay_period_id) REFERENCES pay_periods(id) ON DELETE CASCADE";
+
+    // Standing deductions per employee, caps of 0 mean no cap //
+    std::string deductions_column =
+        "id INTEGER PRIMARY KEY, "
+        "employee_id INTEGER NOT NULL, "
+        "kind TEXT NOT NULL, "
+        "name TEXT NOT NULL, "
+        "pre_tax INTEGER NOT NULL DEFAULT 0, "
+        "percent REAL NOT NULL DEFAULT 0, "
+        "amount REAL NOT NULL DEFAULT 0, "
+        "period_cap REAL NOT NULL DEFAULT 0, "
+        "total_cap REAL NOT NULL DEFAULT 0, "
+        "deducted_total REAL NOT NULL DEFAULT 0, "
+        "is_active INTEGER NOT NULL DEFAULT 1, "
+        "CHECK(percent >= 0 AND amount >= 0 AND period_cap >= 0 AND total_cap >= 0), "
+        "FOREIGN KEY(employee_id) REFERENCES employees(id) ON DELETE CASCADE";
+
+    // Amount each deduction took from a payroll row //
+    std::string payroll_deductions_column =
+        "pay_period_id INTEGER NOT NULL, "
+        "deduction_id INTEGER NOT NULL, "
+        "employee_id INTEGER NOT NULL, "
+        "amount REAL NOT NULL, "
+        "PRIMARY KEY(pay_period_id, deduction_id), "
+        "FOREIGN KEY(pay_period_id) REFERENCES pay_periods(id) ON DELETE CASCADE, "
+        "FOREIGN KEY(deduction_id) REFERENCES deductions(id) ON DELETE CASCADE, "
+        "FOREIGN KEY(employee_id) REFERENCES employees(id) ON DELETE CASCADE";
+
+    // Years whose time entries live in their own database file //
+    std::string time_entry_archives_column =
+        "year INTEGER PRIMARY KEY, "
+        "file_name TEXT NOT NULL, "
+        "entry_count INTEGER NOT NULL DEFAULT 0, "
+        "archived_at DATETIME DEFAULT CURRENT_TIMESTAMP";
+
+    // Time entries added, edited or removed inside an already processed pay period //
+    std::string time_entry_changes_column =
+        "id INTEGER PRIMARY KEY, "
+        "employee_id INTEGER NOT NULL, "
+        "date_worked INTEGER NOT NULL";
+
+    if (!dbUtils::CreateTable(db, "departments", lookup_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "employment_types", lookup_column))
+        return false;
+
     if (!dbUtils::CreateTable(db, "employees", employee_column))
         return false;
 
@@ -70,63 +177,450 @@ bool Database::SetupTables() {
     if (!dbUtils::CreateTable(db, "payroll", payroll_column))
         return false;
 
+    if (!dbUtils::CreateTable(db, "payroll_ytd", payroll_ytd_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "payroll_department_totals", payroll_department_totals_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "payroll_runs", payroll_runs_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "time_entry_changes", time_entry_changes_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "deductions", deductions_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "time_entry_archives", time_entry_archives_column))
+        return false;
+
+    if (!dbUtils::CreateTable(db, "payroll_deductions", payroll_deductions_column))
+        return false;
+
+    // Columns added after the first release //
+    if (!dbUtils::AddColumn(db, "employees", "jurisdiction", "TEXT NOT NULL DEFAULT 'DEFAULT'"))
+        return false;
+
+    if (!dbUtils::AddColumn(db, "employees", "filing_status", "TEXT NOT NULL DEFAULT 'single'"))
+        return false;
+
+    if (!dbUtils::AddColumn(db, "time_entries", "shift_start", "INTEGER"))
+        return false;
+
+    if (!dbUtils::AddColumn(db, "payroll", "tax", "REAL NOT NULL DEFAULT 0"))
+        return false;
+
+    if (!dbUtils::AddColumn(db, "payroll", "hours_worked", "REAL NOT NULL DEFAULT 0"))
+        return false;
+
+    // Dates used to be stored as 'YYYY-MM-DD' text, they are now days since 1970-01-01 //
+    // Converted once, user_version records that the scan does not need to run again    //
+    if (dbUtils::GetSchemaVersion(db) < 1) {
+        if (!dbUtils::ConvertDateColumn(db, "employees", "hire_date"))
+            return false;
+
+        if (!dbUtils::ConvertDateColumn(db, "time_entries", "date_worked"))
+            return false;
+
+        if (!dbUtils::ConvertDateColumn(db, "pay_periods", "start_date"))
+            return false;
+
+        if (!dbUtils::ConvertDateColumn(db, "pay_periods", "end_date"))
+            return false;
+
+        if (!dbUtils::SetSchemaVersion(db, 1))
+            return false;
+    }
+
+    // Payroll rows written before tax was stored only ever had the flat tax deducted //
+    if (dbUtils::GetSchemaVersion(db) < 2) {
+        if (sqlite3_exec(db, "UPDATE payroll SET tax = gross_pay - net_pay;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::cerr << "\nFailed to backfill payroll tax: " << sqlite3_errmsg(db) << '\n';
+            return false;
+        }
+
+        if (!rebuildPayrollYtd() || !dbUtils::SetSchemaVersion(db, 2))
+            return false;
+    }
+
+    // Department and employment type used to be free text on every employee row, //
+    // they move into the lookup tables and employees keep only the ids            //
+    if (dbUtils::GetSchemaVersion(db) < 3) {
+        if (dbUtils::HasColumn(db, "employees", "department")) {
+            if (!dbUtils::AddColumn(db, "employees", "department_id", "INTEGER REFERENCES departments(id)"))
+                return false;
+
+            if (!dbUtils::AddColumn(db, "employees", "employment_type_id", "INTEGER REFERENCES employment_types(id)"))
+                return false;
+
+            const char* migrationSQL =
+                "BEGIN IMMEDIATE; "
+                "INSERT OR IGNORE INTO departments (name) "
+                "SELECT DISTINCT department FROM employees WHERE department IS NOT NULL AND department <> '' ORDER BY department; "
+                "INSERT OR IGNORE INTO employment_types (name) "
+                "SELECT DISTINCT employment_type FROM employees WHERE employment_type IS NOT NULL AND employment_type <> '' ORDER BY employment_type; "
+                "UPDATE employees SET "
+                "department_id = (SELECT id FROM departments WHERE name = employees.department), "
+                "employment_type_id = (SELECT id FROM employment_types WHERE name = employees.employment_type); "
+                "ALTER TABLE employees DROP COLUMN department; "
+                "ALTER TABLE employees DROP COLUMN employment_type; "
+                "COMMIT;";
+
+            if (sqlite3_exec(db, migrationSQL, nullptr, nullptr, nullptr) != SQLITE_OK) {
+                std::cerr << "\nFailed to migrate departments and employment types: " << sqlite3_errmsg(db) << '\n';
+                sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+                return false;
+            }
+        }
+
+        if (!dbUtils::SetSchemaVersion(db, 3))
+            return false;
+    }
+
+    // Department totals for payroll processed before the table existed //
+    if (dbUtils::GetSchemaVersion(db) < 4) {
+        if (!rebuildDepartmentTotals() || !dbUtils::SetSchemaVersion(db, 4))
+            return false;
+    }
+
+    // Pay periods used to need an end after the start, which ruled out one-day periods. A CHECK cannot   //
+    // be altered, so the table is rebuilt, with foreign keys off so payroll rows stay linked. The change //
+    // tracking triggers read pay_periods, they are dropped here and created again further down           //
+    if (dbUtils::GetSchemaVersion(db) < 5) {
+        std::string rebuildSQL =
+            "BEGIN IMMEDIATE; "
+            "DROP TRIGGER IF EXISTS trg_time_entries_insert; "
+            "DROP TRIGGER IF EXISTS trg_time_entries_update; "
+            "DROP TRIGGER IF EXISTS trg_time_entries_delete; "
+            "CREATE TABLE pay_periods_rebuilt (" + pay_periods_column + "); "
+            "INSERT INTO pay_periods_rebuilt (id, start_date, end_date, created_at, processed_at) "
+            "SELECT id, start_date, end_date, created_at, processed_at FROM pay_periods; "
+            "DROP TABLE pay_periods; "
+            "ALTER TABLE pay_periods_rebuilt RENAME TO pay_periods; "
+            "COMMIT;";
+
+        sqlite3_exec(db, "PRAGMA foreign_keys = OFF;", nullptr, nullptr, nullptr);
+        bool rebuilt = sqlite3_exec(db, rebuildSQL.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK;
+        if (!rebuilt) {
+            std::cerr << "\nFailed to rebuild pay_periods: " << sqlite3_errmsg(db) << '\n';
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        }
+        sqlite3_exec(db, "PRAGMA foreign_keys = ON;", nullptr, nullptr, nullptr);
+
+        if (!rebuilt || !dbUtils::SetSchemaVersion(db, 5))
+            return false;
+    }
+
+    // Indexes backing the keyset-paginated listings. The time entry listing pages on (date_worked, id): //
+    // a single column index keeps rowids in order within each date, the pay index below does not        //
+    if (!dbUtils::CreateIndex(db, "idx_time_entries_date", "time_entries", "date_worked"))
+        return false;
+
+    // Covers the date-ordered time entry pass of every payroll run //
+    if (!dbUtils::CreateIndex(db, "idx_time_entries_pay", "time_entries", "date_worked, employee_id, hours_worked, shift_start"))
+        return false;
+
+    if (!dbUtils::CreateIndex(db, "idx_pay_periods_start", "pay_periods", "start_date"))
+        return false;
+
+    if (!dbUtils::CreateIndex(db, "idx_payroll_period", "payroll", "pay_period_id, employee_id"))
+        return false;
+
+    if (!dbUtils::CreateIndex(db, "idx_employees_name", "employees", "last_name, first_name"))
+        return false;
+
+    if (!dbUtils::CreateIndex(db, "idx_time_entry_changes_date", "time_entry_changes", "date_worked, employee_id"))
+        return false;
+
+    // Per-department rollups group on the id alone, without reading employee rows //
+    if (!dbUtils::CreateIndex(db, "idx_employees_department", "employees", "department_id, employment_type_id"))
+        return false;
+
+    // Payroll runs load the active deductions in employee order //
+    if (!dbUtils::CreateIndex(db, "idx_deductions_employee", "deductions", "employee_id, id"))
+        return false;
+
+    // Change tracking: only entries dated inside a processed period are logged, //
+    // so normal data entry for open periods costs nothing extra                 //
+    auto logChange = [](const std::string& row) {
+        return "INSERT INTO time_entry_changes (employee_id, date_worked) "
+            "SELECT " + row + ".employee_id, " + row + ".date_worked "
+            "WHERE EXISTS (SELECT 1 FROM pay_periods WHERE processed_at IS NOT NULL "
+            "AND start_date <= " + row + ".date_worked AND end_date >= " + row + ".date_worked); ";
+    };
+
+    if (!dbUtils::CreateTrigger(db, "trg_time_entries_insert", "AFTER INSERT ON time_entries", logChange("NEW")))
+        return false;
+
+    if (!dbUtils::CreateTrigger(db, "trg_time_entries_update", "AFTER UPDATE ON time_entries", logChange("OLD") + logChange("NEW")))
+        return false;
+
+    if (!dbUtils::CreateTrigger(db, "trg_time_entries_delete", "AFTER DELETE ON time_entries", logChange("OLD")))
+        return false;
+
+    return loadDictionary("departments", departments) && loadDictionary("employment_types", employmentTypes)
+        && loadPayPeriodIndex() && loadEmployeeNameIndex() && loadTimeEntryArchives();
+}
+
+bool Database::loadPayPeriodIndex() {
+    const char* SQL = "SELECT id, start_date, end_date FROM pay_periods;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    payPeriodIndex.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        payPeriodIndex.add(sqlite3_column_int(stmt, 0), Date{ sqlite3_column_int(stmt, 1) }, Date{ sqlite3_column_int(stmt, 2) });
+
+    sqlite3_finalize(stmt);
     return true;
 }
 
-bool Database::addPayPeriod(const std::string& startDate, const std::string& endDate) {
-    const char* SQL = "INSERT INTO pay_periods (start_date, end_date) VALUES (?, ?);";
+// Department names come from the dictionary loaded before it //
+bool Database::loadEmployeeNameIndex() {
+    const char* SQL = "SELECT id, first_name, last_name, department_id FROM employees;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    employeeNameIndex.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        employeeNameIndex.add(sqlite3_column_int(stmt, 0),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+            departments.name(sqlite3_column_int(stmt, 3)));
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool Database::loadTimeEntryArchives() {
+    const char* SQL = "SELECT year, file_name, entry_count, archived_at FROM time_entry_archives;";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, startDate.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 2, endDate.c_str(), -1, SQLITE_STATIC);
+    timeEntryArchives.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        TimeEntryArchive archive;
+        archive.year = sqlite3_column_int(stmt, 0);
+        archive.fileName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        archive.entryCount = sqlite3_column_int(stmt, 2);
+        archive.archivedAt = sqlite3_column_text(stmt, 3) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) : "";
+
+        timeEntryArchives[archive.year] = archive;
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool Database::loadDictionary(const std::string& tableName, Dictionary& dictionary) {
+    std::string SQL = "SELECT id, name FROM " + tableName + ";";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    dictionary.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+        dictionary.add(sqlite3_column_int(stmt, 0), reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+// Returns the id stored for name, adding it to the lookup table the first time it is seen. //
+// An empty name is stored as NULL (id 0)                                                  //
+bool Database::internName(const std::string& tableName, Dictionary& dictionary, const std::string& name, int& id) {
+    id = name.empty() ? 0 : dictionary.find(name);
+    if (name.empty() || id != 0)
+        return true;
+
+    std::string SQL = "INSERT INTO " + tableName + " (name) VALUES (?) "
+        "ON CONFLICT(name) DO UPDATE SET name = excluded.name RETURNING id;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, name.c_str(), -1, SQLITE_STATIC);
 
     int result = sqlite3_step(stmt);
+    if (result == SQLITE_ROW)
+        id = sqlite3_column_int(stmt, 0);
+
     sqlite3_finalize(stmt);
 
-    if (result != SQLITE_DONE) {
-        std::cout << "\nSQL Error: " << sqlite3_errmsg(db) << '\n';
+    if (result != SQLITE_ROW) {
+        std::cerr << "\nFailed to store " << name << " in " << tableName << ": " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
+    dictionary.add(id, name);
     return true;
 }
 
-bool Database::removePayPeriod(const int& payPeriodID) {
-    const char* SQL = "DELETE FROM pay_periods WHERE id = ?;";
+bool Database::internDepartment(const std::string& name, int& departmentID) {
+    return internName("departments", departments, name, departmentID);
+}
+
+bool Database::internEmploymentType(const std::string& name, int& employmentTypeID) {
+    return internName("employment_types", employmentTypes, name, employmentTypeID);
+}
+
+const Dictionary& Database::getDepartments() const {
+    return departments;
+}
+
+const Dictionary& Database::getEmploymentTypes() const {
+    return employmentTypes;
+}
+
+// Rejects a period sharing any day with an existing one, since its hours would be paid twice //
+bool Database::addPayPeriod(const Date& startDate, const Date& endDate) {
+    int overlappingID = payPeriodIndex.findOverlap(startDate, endDate);
+    if (overlappingID != 0) {
+        std::cerr << "\nPay period overlaps pay period ID " << overlappingID << '\n';
+        return false;
+    }
+
+    if (isArchived(startDate) || isArchived(endDate)) {
+        std::cerr << "\nPay period falls in a closed year whose time entries are archived\n";
+        return false;
+    }
+
+    const char* SQL = "INSERT INTO pay_periods (start_date, end_date) VALUES (?, ?);";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, payPeriodID);
+    sqlite3_bind_int(stmt, 1, startDate.days);
+    sqlite3_bind_int(stmt, 2, endDate.days);
 
     int result = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
     if (result != SQLITE_DONE) {
+        std::cout << "\nSQL Error: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    payPeriodIndex.add(static_cast<int>(sqlite3_last_insert_rowid(db)), startDate, endDate);
+    return true;
+}
+
+bool Database::removePayPeriod(const int& payPeriodID) {
+    // The cascade removes the period's payroll rows, so their amounts leave the YTD totals first //
+    const char* ytdSQL = "UPDATE payroll_ytd SET "
+        "gross_pay = payroll_ytd.gross_pay - pr.gross_pay, "
+        "net_pay = payroll_ytd.net_pay - pr.net_pay, "
+        "tax = payroll_ytd.tax - pr.tax, "
+        "hours_worked = payroll_ytd.hours_worked - pr.hours_worked "
+        "FROM payroll pr JOIN pay_periods p ON p.id = pr.pay_period_id "
+        "WHERE pr.pay_period_id = ? AND payroll_ytd.employee_id = pr.employee_id "
+        "AND payroll_ytd.year = CAST(strftime('%Y', p.end_date * 86400, 'unixepoch') AS INTEGER);";
+
+    // Likewise what its deductions took goes back under their total caps //
+    const char* deductionsSQL = "UPDATE deductions SET deducted_total = deductions.deducted_total - pd.amount "
+        "FROM payroll_deductions pd WHERE pd.pay_period_id = ? AND pd.deduction_id = deductions.id;";
+
+    const char* SQL = "DELETE FROM pay_periods WHERE id = ?;";
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
         std::cerr << "\nSQL Error: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
+    for (const char* statementSQL : { ytdSQL, deductionsSQL, SQL }) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, statementSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+
+        sqlite3_bind_int(stmt, 1, payPeriodID);
+
+        int result = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+
+        if (result != SQLITE_DONE) {
+            std::cerr << "\nSQL Error: " << sqlite3_errmsg(db) << '\n';
+            sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+            return false;
+        }
+    }
+
     if (sqlite3_changes(db) == 0) {
         std::cout << "\nPay Period Not Found\n";
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
         return false;
     }
 
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        return false;
+
+    payPeriodIndex.remove(payPeriodID);
     return true;
 }
 
-bool Database::insertPayrollForPayPeriod(const int& payPeriodID) {
+const PayPeriodIndex& Database::getPayPeriodIndex() const {
+    return payPeriodIndex;
+}
+
+// Streams every time entry whose date falls in no pay period or in more than one, in date order. //
+// The entries are read through idx_time_entries_pay and matched against the in-memory index       //
+int Database::auditTimeEntryCoverage(const RowVisitor<TimeEntryCoverage>& visitor) {
+    const char* SQL = "SELECT employee_id, date_worked, hours_worked, COALESCE(shift_start, -1) "
+        "FROM time_entries ORDER BY date_worked ASC, employee_id ASC;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return -1;
+    }
+
+    TimeEntryCoverage coverage;
+    int rowCount{ 0 };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        coverage.entry.employeeID = sqlite3_column_int(stmt, 0);
+        coverage.entry.dateWorked.days = sqlite3_column_int(stmt, 1);
+        coverage.entry.hoursWorked = sqlite3_column_double(stmt, 2);
+        coverage.entry.shiftStart = sqlite3_column_int(stmt, 3);
+
+        payPeriodIndex.covering(coverage.entry.dateWorked, coverage.payPeriodIDs);
+        if (coverage.payPeriodIDs.size() == 1)
+            continue;
+
+        rowCount++;
+        if (!visitor(coverage))
+            break;
+    }
+
+    sqlite3_finalize(stmt);
+    return rowCount;
+}
+
+bool Database::insertPayrollForPayPeriod(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules) {
     // ---------------------------------------------------------- //
     // Validating pay period and retrieving start_date & end_date //
     // ---------------------------------------------------------- //
 
-    int consoleWaitTimer = 500;
     std::cout << "Validating Pay Period ID . . .\n";
     std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
 
@@ -158,13 +652,30 @@ bool Database::insertPayrollForPayPeriod(const int& payPeriodID) {
     
     std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
 
-    std::string startDate = reinterpret_cast<const char*>(sqlite3_column_text(payPeriodStmt, 0));
-    std::string endDate = reinterpret_cast<const char*>(sqlite3_column_text(payPeriodStmt, 1));
+    Date startDate{ sqlite3_column_int(payPeriodStmt, 0) };
+    Date endDate{ sqlite3_column_int(payPeriodStmt, 1) };
     sqlite3_finalize(payPeriodStmt);
 
-    std::cout << "Start Date: " << startDate << '\n' << "End Date: " << endDate << '\n';
+    PayCalculator calculator(taxEngine, payRules, startDate, endDate);
+
+    std::cout << "Start Date: " << startDate.toString() << '\n' << "End Date: " << endDate.toString() << '\n';
     std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
 
+    // ------------------------------------------------------------------ //
+    // Resuming after the last chunk committed by an interrupted run      //
+    // ------------------------------------------------------------------ //
+
+    int resumeAfterID{ 0 };
+    int employeesDone{ 0 };
+    if (!getPayrollRunCheckpoint(payPeriodID, resumeAfterID, employeesDone))
+        return false;
+
+    if (resumeAfterID > 0) {
+        std::cout << "Resuming interrupted payroll run after employee ID " << resumeAfterID
+            << " (" << employeesDone << " employee(s) already committed)\n";
+        std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+    }
+
     // ------------------------------------------------------- //
     // Retrieving all active employees for payroll calculation //
     // ------------------------------------------------------- //
@@ -172,161 +683,1397 @@ bool Database::insertPayrollForPayPeriod(const int& payPeriodID) {
     std::cout << "Retrieving active employees for payroll calculation . . ." << '\n';
     std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
 
-    const char* employeesSQL = "SELECT id, hourly_rate FROM employees WHERE is_active = 1;";
-    sqlite3_stmt* employeesStmt;
-    if (sqlite3_prepare_v2(db, employeesSQL, -1, &employeesStmt, nullptr) != SQLITE_OK) {
-        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+    auto rollback = [this]() {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    };
+
+    // Employees and hours are read from one snapshot //
+    if (sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start payroll transaction: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
-    int employeeCount{ 0 };
-    while (sqlite3_step(employeesStmt) == SQLITE_ROW) {
-        employeeCount++;
-        int employeeID = sqlite3_column_int(employeesStmt, 0);
-        double hourlyRate = sqlite3_column_double(employeesStmt, 1);
+    struct ActiveEmployee {
+        int id;
+        int taxTable;
+        double hourlyRate;
+        HoursAccumulator hours;
+    };
 
-        std::cout << "Processing Employee ID: " << employeeID << " | Hourly Rate: $" << hourlyRate << '\n';
-        std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+    std::vector<ActiveEmployee> employees;
+    std::unordered_map<int, size_t> employeeIndex;
 
-        // ------------------------------------------------ //
-        // Calculating total hours worked for each employee //
-        // ------------------------------------------------ //
+    const char* employeesSQL = "SELECT id, hourly_rate, jurisdiction, filing_status FROM employees WHERE is_active = 1 AND id > ? ORDER BY id;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, employeesSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
 
-        const char* timeEntriesSQL = "SELECT SUM(hours_worked) FROM time_entries WHERE employee_id = ? AND date_worked BETWEEN ? and ?;";
-        sqlite3_stmt* timeEntriesStmt;
-        if (sqlite3_prepare_v2(db, timeEntriesSQL, -1, &timeEntriesStmt, nullptr) != SQLITE_OK) {
-            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-            sqlite3_finalize(employeesStmt);
-            return false;
-        }
-    
-        sqlite3_bind_int(timeEntriesStmt, 1, employeeID);
-        sqlite3_bind_text(timeEntriesStmt, 2, startDate.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(timeEntriesStmt, 3, endDate.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 1, resumeAfterID);
 
-        double totalHours{ 0.0 };
-        if (sqlite3_step(timeEntriesStmt) == SQLITE_ROW) {
-            totalHours = sqlite3_column_double(timeEntriesStmt, 0);
-        }
-        sqlite3_finalize(timeEntriesStmt);
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ActiveEmployee emp;
+        emp.id = sqlite3_column_int(stmt, 0);
+        emp.hourlyRate = sqlite3_column_double(stmt, 1);
+        emp.taxTable = taxEngine.findTable(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
 
-        std::cout << "Total Hours Worked: " << totalHours << '\n';
-        std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+        employeeIndex[emp.id] = employees.size();
+        employees.push_back(emp);
+    }
+    sqlite3_finalize(stmt);
 
-        // -------------------------------------------------------- //
-        // Calculating gross/net pay, and inserting it into payroll // 
-        // -------------------------------------------------------- //
+    // Their deductions, loaded once in the same order as the employees //
+    std::vector<int> employeeIDs;
+    for (const ActiveEmployee& emp : employees)
+        employeeIDs.push_back(emp.id);
 
-        double grossPay = totalHours * hourlyRate;
-        double taxRate = 0.15; // 15% tax (you can adjust this or add more taxes)
-        double netPay = grossPay * (1 - taxRate); // Deduct taxes here
+    DeductionTable deductions;
+    if (!loadDeductions(payPeriodID, employeeIDs, deductions))
+        return rollback();
 
-        std::cout << "Gross Pay: $" << grossPay << " | Net Pay After 15% Tax: $" << netPay << '\n';
-        std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
-    
-        const char* insertPayrollSQL = "INSERT INTO payroll(employee_id, pay_period_id, gross_pay, net_pay) VALUES (?, ?, ?, ?);";
-        sqlite3_stmt* insertPayrollStmt;
-        if (sqlite3_prepare_v2(db, insertPayrollSQL, -1, &insertPayrollStmt, nullptr) != SQLITE_OK) {
-            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-            sqlite3_finalize(employeesStmt);
-            return false;
-        }
+    // ----------------------------------------------------------------------- //
+    // One date-ordered pass over the period's time entries (covering index), //
+    // overtime and differentials are evaluated as each entry is added        //
+    // ----------------------------------------------------------------------- //
+
+    bool scanned = scanPayrollEntries(startDate, endDate, [&](const TimeEntry& entry) {
+        auto emp = employeeIndex.find(entry.employeeID);
+        if (emp != employeeIndex.end()) // Otherwise inactive or already paid
+            calculator.addEntry(employees[emp->second].hours, entry.dateWorked, entry.hoursWorked, entry.shiftStart);
+
+        return true;
+    });
+
+    if (!scanned)
+        return rollback();
+
+    sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+
+    // ------------------------------------------------------------------------ //
+    // Writing payroll in employee ID order, one transaction per chunk. Each    //
+    // chunk also moves the run journal forward, so a crash loses at most the   //
+    // chunk in progress and the next run starts after the last committed one  //
+    // ------------------------------------------------------------------------ //
+
+    const char* insertPayrollSQL = "INSERT INTO payroll(employee_id, pay_period_id, gross_pay, net_pay, tax, hours_worked) VALUES (?, ?, ?, ?, ?, ?);";
+    const char* journalSQL = "INSERT INTO payroll_runs (pay_period_id, last_employee_id, employees_done) VALUES (?1, ?2, ?3) "
+        "ON CONFLICT(pay_period_id) DO UPDATE SET last_employee_id = ?2, employees_done = ?3, updated_at = CURRENT_TIMESTAMP;";
+
+    sqlite3_stmt* insertPayrollStmt;
+    sqlite3_stmt* ytdStmt;
+    sqlite3_stmt* journalStmt;
+
+    if (sqlite3_prepare_v2(db, insertPayrollSQL, -1, &insertPayrollStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    if (sqlite3_prepare_v2(db, payrollYtdUpsertSQL, -1, &ytdStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(insertPayrollStmt);
+        return false;
+    }
+
+    if (sqlite3_prepare_v2(db, journalSQL, -1, &journalStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(insertPayrollStmt);
+        sqlite3_finalize(ytdStmt);
+        return false;
+    }
+
+    // Year-to-date totals are booked in the year the period ends (pay date) //
+    int payYear = endDate.year();
+
+    std::vector<AppliedDeduction> appliedDeductions;
+
+    bool success{ true };
+    for (size_t chunkStart = 0; success && chunkStart < employees.size(); chunkStart += payrollChunkSize) {
+        size_t chunkEnd = std::min(employees.size(), chunkStart + payrollChunkSize);
+
+        if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::cerr << "\nFailed to start payroll transaction: " << sqlite3_errmsg(db) << '\n';
+            success = false;
+            break;
+        }
+
+        for (size_t employee = chunkStart; success && employee < chunkEnd; employee++) {
+            const ActiveEmployee& emp = employees[employee];
+
+            std::cout << "Processing Employee ID: " << emp.id << " | Hourly Rate: $" << emp.hourlyRate << '\n';
+            std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+
+            // -------------------------------------------------------- //
+            // Calculating gross/net pay, and inserting it into payroll // 
+            // -------------------------------------------------------- //
+
+            PayResult pay = calculator.calculate(emp.hours, emp.hourlyRate, emp.taxTable, deductions.forEmployee(employee), deductions.countFor(employee));
+            deductions.collect(employee, emp.id, appliedDeductions);
+
+            std::cout << "Total Hours Worked: " << pay.hoursWorked << " | Overtime: " << pay.overtimeHours << '\n';
+            std::cout << "Gross Pay: $" << pay.grossPay << " | Tax: $" << pay.tax << " | Deductions: $" << pay.deductions << " | Net Pay: $" << pay.netPay << '\n';
+            std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+
+            sqlite3_bind_int(insertPayrollStmt, 1, emp.id);
+            sqlite3_bind_int(insertPayrollStmt, 2, payPeriodID);
+            sqlite3_bind_double(insertPayrollStmt, 3, pay.grossPay);
+            sqlite3_bind_double(insertPayrollStmt, 4, pay.netPay);
+            sqlite3_bind_double(insertPayrollStmt, 5, pay.tax);
+            sqlite3_bind_double(insertPayrollStmt, 6, pay.hoursWorked);
+
+            int insertPayrollResult = sqlite3_step(insertPayrollStmt);
+            sqlite3_reset(insertPayrollStmt);
+
+            if (insertPayrollResult != SQLITE_DONE) {
+                std::cerr << "\nFailed to insert payroll: " << sqlite3_errmsg(db) << '\n';
+                success = false;
+                break;
+            }
+
+            success = addToPayrollYtd(ytdStmt, emp.id, payYear, pay);
+            if (!success)
+                break;
+
+            std::cout << "Payroll Inserted Successfully for Employee ID: " << emp.id << '\n';
+            std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+        }
+
+        if (!success || !recordDeductions(payPeriodID, appliedDeductions)) {
+            rollback();
+            success = false;
+            break;
+        }
+
+        appliedDeductions.clear();
+        employeesDone += static_cast<int>(chunkEnd - chunkStart);
+
+        sqlite3_bind_int(journalStmt, 1, payPeriodID);
+        sqlite3_bind_int(journalStmt, 2, employees[chunkEnd - 1].id);
+        sqlite3_bind_int(journalStmt, 3, employeesDone);
+
+        int journalResult = sqlite3_step(journalStmt);
+        sqlite3_reset(journalStmt);
+
+        if (journalResult != SQLITE_DONE || sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+            std::cerr << "\nFailed to commit payroll: " << sqlite3_errmsg(db) << '\n';
+            rollback();
+            success = false;
+            break;
+        }
+
+        std::cout << "Committed payroll up to employee ID " << employees[chunkEnd - 1].id << '\n';
+    }
+
+    sqlite3_finalize(insertPayrollStmt);
+    sqlite3_finalize(ytdStmt);
+    sqlite3_finalize(journalStmt);
+
+    if (!success) {
+        std::cerr << "\nPayroll run stopped, committed employees are kept and processing the period again resumes from there\n";
+        return false;
+    }
+
+    if (employeesDone == 0)
+        std::cout << "\nNo active employees found for this pay period\n";
+    else
+        std::cout << "\nPayroll processing completed for " << employeesDone << " employees(s)" << '\n';
+
+    // -------------------------------------------------------------------- //
+    // Marking pay period as processed once every chunk is in, the journal //
+    // entry is removed in the same transaction                             //
+    // -------------------------------------------------------------------- //
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start payroll transaction: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    if (!refreshDepartmentTotals(payPeriodID) || !clearTimeEntryChanges(startDate, endDate))
+        return rollback();
+
+    const char* updateSQL = "UPDATE pay_periods SET processed_at = CURRENT_TIMESTAMP WHERE id = ?;";
+    const char* journalDeleteSQL = "DELETE FROM payroll_runs WHERE pay_period_id = ?;";
+
+    for (const char* statementSQL : { updateSQL, journalDeleteSQL }) {
+        sqlite3_stmt* updateStmt;
+        if (sqlite3_prepare_v2(db, statementSQL, -1, &updateStmt, nullptr) != SQLITE_OK) {
+            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+            return rollback();
+        }
+
+        sqlite3_bind_int(updateStmt, 1, payPeriodID);
+
+        int updateResult = sqlite3_step(updateStmt);
+        sqlite3_finalize(updateStmt);
+
+        if (updateResult != SQLITE_DONE) {
+            std::cerr << "\nFailed to mark pay period as processed: " << sqlite3_errmsg(db) << '\n';
+            return rollback();
+        }
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to commit payroll: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+    std::cout << "Pay period successfully marked as processed\n";
+
+    return true;
+}
+
+bool Database::reprocessPayPeriod(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules, int& employeesUpdated) {
+    employeesUpdated = 0;
+
+    // Archived years the period reaches into are attached first, SQLite cannot attach inside a transaction //
+    const PayPeriodIndex::Period* period = payPeriodIndex.find(payPeriodID);
+    if (period != nullptr && !attachArchives(period->startDate, period->endDate))
+        return false;
+
+    auto rollback = [this]() {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    };
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start payroll transaction: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    const char* payPeriodSQL = "SELECT start_date, end_date, processed_at FROM pay_periods WHERE id = ?;";
+    sqlite3_stmt* payPeriodStmt;
+    if (sqlite3_prepare_v2(db, payPeriodSQL, -1, &payPeriodStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    sqlite3_bind_int(payPeriodStmt, 1, payPeriodID);
+
+    if (sqlite3_step(payPeriodStmt) != SQLITE_ROW) {
+        std::cerr << "\nPay period not found\n";
+        sqlite3_finalize(payPeriodStmt);
+        return rollback();
+    }
+
+    if (sqlite3_column_type(payPeriodStmt, 2) == SQLITE_NULL) {
+        std::cerr << "\nPay period has not been processed yet, process it normally first\n";
+        sqlite3_finalize(payPeriodStmt);
+        return rollback();
+    }
+
+    Date startDate{ sqlite3_column_int(payPeriodStmt, 0) };
+    Date endDate{ sqlite3_column_int(payPeriodStmt, 1) };
+    sqlite3_finalize(payPeriodStmt);
+
+    PayCalculator calculator(taxEngine, payRules, startDate, endDate);
+    int payYear = endDate.year();
+
+    // Only employees with logged changes are recomputed, together with what they were paid before //
+    const char* changedSQL = "SELECT e.id, e.hourly_rate, e.jurisdiction, e.filing_status, "
+        "pr.id IS NOT NULL, pr.gross_pay, pr.net_pay, pr.tax, pr.hours_worked "
+        "FROM (SELECT DISTINCT employee_id FROM time_entry_changes WHERE date_worked BETWEEN ?2 AND ?3) c "
+        "JOIN employees e ON e.id = c.employee_id "
+        "LEFT JOIN payroll pr ON pr.employee_id = e.id AND pr.pay_period_id = ?1 "
+        "WHERE e.is_active = 1 OR pr.id IS NOT NULL ORDER BY e.id;";
+
+    const char* upsertPayrollSQL = "INSERT INTO payroll (employee_id, pay_period_id, gross_pay, net_pay, tax, hours_worked) VALUES (?, ?, ?, ?, ?, ?) "
+        "ON CONFLICT(employee_id, pay_period_id) DO UPDATE SET "
+        "gross_pay = excluded.gross_pay, net_pay = excluded.net_pay, tax = excluded.tax, hours_worked = excluded.hours_worked;";
+
+    struct ChangedEmployee {
+        int id;
+        int taxTable;
+        double hourlyRate;
+        PayResult previous;
+        HoursAccumulator hours;
+    };
+
+    std::vector<ChangedEmployee> employees;
+    std::unordered_map<int, size_t> employeeIndex;
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, changedSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+    sqlite3_bind_int(stmt, 2, startDate.days);
+    sqlite3_bind_int(stmt, 3, endDate.days);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ChangedEmployee emp;
+        emp.id = sqlite3_column_int(stmt, 0);
+        emp.hourlyRate = sqlite3_column_double(stmt, 1);
+        emp.taxTable = taxEngine.findTable(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+
+        if (sqlite3_column_int(stmt, 4)) {
+            emp.previous.grossPay = sqlite3_column_double(stmt, 5);
+            emp.previous.netPay = sqlite3_column_double(stmt, 6);
+            emp.previous.tax = sqlite3_column_double(stmt, 7);
+            emp.previous.hoursWorked = sqlite3_column_double(stmt, 8);
+        }
+
+        employeeIndex[emp.id] = employees.size();
+        employees.push_back(emp);
+    }
+    sqlite3_finalize(stmt);
+
+    std::vector<int> employeeIDs;
+    for (const ChangedEmployee& emp : employees)
+        employeeIDs.push_back(emp.id);
+
+    DeductionTable deductions;
+    if (!loadDeductions(payPeriodID, employeeIDs, deductions))
+        return rollback();
+
+    // Their hours come from the same date-ordered pass over the period as a normal run //
+    bool scanned = scanPayrollEntries(startDate, endDate, [&](const TimeEntry& entry) {
+        auto emp = employeeIndex.find(entry.employeeID);
+        if (emp != employeeIndex.end())
+            calculator.addEntry(employees[emp->second].hours, entry.dateWorked, entry.hoursWorked, entry.shiftStart);
+
+        return true;
+    });
+
+    if (!scanned)
+        return rollback();
+
+    sqlite3_stmt* upsertPayrollStmt;
+    sqlite3_stmt* ytdStmt;
+
+    if (sqlite3_prepare_v2(db, upsertPayrollSQL, -1, &upsertPayrollStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    if (sqlite3_prepare_v2(db, payrollYtdUpsertSQL, -1, &ytdStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(upsertPayrollStmt);
+        return rollback();
+    }
+
+    std::vector<AppliedDeduction> appliedDeductions;
+
+    bool success{ true };
+    for (size_t employee = 0; employee < employees.size(); employee++) {
+        const ChangedEmployee& emp = employees[employee];
+        PayResult pay = calculator.calculate(emp.hours, emp.hourlyRate, emp.taxTable, deductions.forEmployee(employee), deductions.countFor(employee));
+        deductions.collect(employee, emp.id, appliedDeductions);
+
+        sqlite3_bind_int(upsertPayrollStmt, 1, emp.id);
+        sqlite3_bind_int(upsertPayrollStmt, 2, payPeriodID);
+        sqlite3_bind_double(upsertPayrollStmt, 3, pay.grossPay);
+        sqlite3_bind_double(upsertPayrollStmt, 4, pay.netPay);
+        sqlite3_bind_double(upsertPayrollStmt, 5, pay.tax);
+        sqlite3_bind_double(upsertPayrollStmt, 6, pay.hoursWorked);
+
+        int upsertResult = sqlite3_step(upsertPayrollStmt);
+        sqlite3_reset(upsertPayrollStmt);
+
+        if (upsertResult != SQLITE_DONE) {
+            std::cerr << "\nFailed to update payroll for employee ID " << emp.id << ": " << sqlite3_errmsg(db) << '\n';
+            success = false;
+            break;
+        }
+
+        PayResult difference;
+        difference.grossPay = pay.grossPay - emp.previous.grossPay;
+        difference.netPay = pay.netPay - emp.previous.netPay;
+        difference.tax = pay.tax - emp.previous.tax;
+        difference.hoursWorked = pay.hoursWorked - emp.previous.hoursWorked;
+
+        if (!addToPayrollYtd(ytdStmt, emp.id, payYear, difference)) {
+            success = false;
+            break;
+        }
+
+        employeesUpdated++;
+    }
+
+    sqlite3_finalize(upsertPayrollStmt);
+    sqlite3_finalize(ytdStmt);
+
+    if (!success || !recordDeductions(payPeriodID, appliedDeductions)
+        || !refreshDepartmentTotals(payPeriodID) || !clearTimeEntryChanges(startDate, endDate))
+        return rollback();
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to commit payroll: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    return true;
+}
+
+// Computes the period's payroll with overridden rates, tax tables and pay rules using the same //
+// calculator as a real run. Everything is read in one snapshot and nothing is written          //
+bool Database::simulatePayroll(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules, const PayrollOverrides& overrides, std::vector<PayrollSimulation>& results) {
+    results.clear();
+
+    const PayPeriodIndex::Period* period = payPeriodIndex.find(payPeriodID);
+    if (period != nullptr && !attachArchives(period->startDate, period->endDate))
+        return false;
+
+    if (sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start read transaction: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    auto endSnapshot = [this](bool success) {
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        return success;
+    };
+
+    const char* payPeriodSQL = "SELECT start_date, end_date FROM pay_periods WHERE id = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, payPeriodSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return endSnapshot(false);
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "\nPay period not found\n";
+        sqlite3_finalize(stmt);
+        return endSnapshot(false);
+    }
+
+    Date startDate{ sqlite3_column_int(stmt, 0) };
+    Date endDate{ sqlite3_column_int(stmt, 1) };
+    sqlite3_finalize(stmt);
+
+    PayCalculator calculator(taxEngine, payRules, startDate, endDate);
+
+    // Everyone a real run would pay now, plus anyone the last real run paid //
+    const char* employeesSQL = "SELECT e.id, e.hourly_rate, e.jurisdiction, e.filing_status, "
+        "pr.id IS NOT NULL, pr.gross_pay, pr.net_pay, pr.tax, pr.hours_worked "
+        "FROM employees e LEFT JOIN payroll pr ON pr.employee_id = e.id AND pr.pay_period_id = ? "
+        "WHERE e.is_active = 1 OR pr.id IS NOT NULL ORDER BY e.id;";
+
+    if (sqlite3_prepare_v2(db, employeesSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return endSnapshot(false);
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+
+    struct SimulatedEmployee {
+        int taxTable;
+        double hourlyRate;
+        HoursAccumulator hours;
+    };
+
+    std::vector<SimulatedEmployee> employees;
+    std::unordered_map<int, size_t> employeeIndex;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        PayrollSimulation result;
+        result.employeeID = sqlite3_column_int(stmt, 0);
+        result.hasCurrent = sqlite3_column_int(stmt, 4) != 0;
+
+        if (result.hasCurrent) {
+            result.current.grossPay = sqlite3_column_double(stmt, 5);
+            result.current.netPay = sqlite3_column_double(stmt, 6);
+            result.current.tax = sqlite3_column_double(stmt, 7);
+            result.current.hoursWorked = sqlite3_column_double(stmt, 8);
+        }
+
+        SimulatedEmployee emp;
+        emp.hourlyRate = sqlite3_column_double(stmt, 1) * (1.0 + overrides.rateChangePercent / 100.0);
+        emp.taxTable = taxEngine.findTable(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+
+        auto rate = overrides.hourlyRates.find(result.employeeID);
+        if (rate != overrides.hourlyRates.end())
+            emp.hourlyRate = rate->second;
+
+        employeeIndex[result.employeeID] = employees.size();
+        employees.push_back(emp);
+        results.push_back(result);
+    }
+    sqlite3_finalize(stmt);
+
+    std::vector<int> employeeIDs;
+    for (const PayrollSimulation& result : results)
+        employeeIDs.push_back(result.employeeID);
+
+    DeductionTable deductions;
+    if (!loadDeductions(payPeriodID, employeeIDs, deductions)) {
+        results.clear();
+        return endSnapshot(false);
+    }
+
+    bool scanned = scanPayrollEntries(startDate, endDate, [&](const TimeEntry& entry) {
+        auto emp = employeeIndex.find(entry.employeeID);
+        if (emp != employeeIndex.end())
+            calculator.addEntry(employees[emp->second].hours, entry.dateWorked, entry.hoursWorked, entry.shiftStart);
+
+        return true;
+    });
+
+    if (!scanned) {
+        results.clear();
+        return endSnapshot(false);
+    }
+
+    for (size_t i = 0; i < employees.size(); i++)
+        results[i].simulated = calculator.calculate(employees[i].hours, employees[i].hourlyRate, employees[i].taxTable, deductions.forEmployee(i), deductions.countFor(i));
+
+    return endSnapshot(true);
+}
+
+bool Database::processOpenPayPeriods(const TaxEngine& taxEngine, const PayRules& payRules, int& periodsProcessed, int& recordsWritten) {
+    periodsProcessed = 0;
+    recordsWritten = 0;
+
+    auto rollback = [this]() {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    };
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start payroll transaction: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    // ----------------------------------------------------- //
+    // Loading open periods (sorted) and the active workforce //
+    // ----------------------------------------------------- //
+
+    std::vector<PayPeriod> openPeriods;
+    std::vector<int> periodStarts;
+
+    sqlite3_stmt* stmt;
+    // Periods with an interrupted chunked run already hold some payroll rows, they are finished by resuming that run //
+    const char* periodsSQL = "SELECT id, start_date, end_date FROM pay_periods WHERE processed_at IS NULL "
+        "AND id NOT IN (SELECT pay_period_id FROM payroll_runs) ORDER BY start_date ASC;";
+    if (sqlite3_prepare_v2(db, periodsSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        PayPeriod period;
+        period.id = sqlite3_column_int(stmt, 0);
+        period.startDate.days = sqlite3_column_int(stmt, 1);
+        period.endDate.days = sqlite3_column_int(stmt, 2);
+
+        openPeriods.push_back(period);
+        periodStarts.push_back(period.startDate.days);
+    }
+    sqlite3_finalize(stmt);
+
+    if (openPeriods.empty()) {
+        std::cout << "\nNo open pay periods found\n";
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        return true;
+    }
+
+    struct ActiveEmployee {
+        int id;
+        int taxTable;
+        double hourlyRate;
+    };
+
+    std::vector<ActiveEmployee> employees;
+    std::unordered_map<int, int> employeeIndex;
+
+    const char* employeesSQL = "SELECT id, hourly_rate, jurisdiction, filing_status FROM employees WHERE is_active = 1 ORDER BY id;";
+    if (sqlite3_prepare_v2(db, employeesSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ActiveEmployee emp;
+        emp.id = sqlite3_column_int(stmt, 0);
+        emp.hourlyRate = sqlite3_column_double(stmt, 1);
+        emp.taxTable = taxEngine.findTable(
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)),
+            reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+
+        employeeIndex[emp.id] = static_cast<int>(employees.size());
+        employees.push_back(emp);
+    }
+    sqlite3_finalize(stmt);
+
+    // None of the open periods has deductions recorded yet, so period 0 matches no detail rows //
+    std::vector<int> employeeIDs;
+    for (const ActiveEmployee& emp : employees)
+        employeeIDs.push_back(emp.id);
+
+    DeductionTable deductions;
+    if (!loadDeductions(0, employeeIDs, deductions))
+        return rollback();
+
+    // -------------------------------------------------------------------------------- //
+    // One date-ordered scan of time_entries, each entry is assigned to its pay period   //
+    // by binary search over the sorted start dates and added to that (period, employee) //
+    // -------------------------------------------------------------------------------- //
+
+    std::vector<PayCalculator> calculators;
+    for (const PayPeriod& period : openPeriods)
+        calculators.emplace_back(taxEngine, payRules, period.startDate, period.endDate);
+
+    std::vector<HoursAccumulator> hours(openPeriods.size() * employees.size());
+
+    Date lastEnd = openPeriods.front().endDate;
+    for (const PayPeriod& period : openPeriods)
+        lastEnd = std::max(lastEnd, period.endDate);
+
+    bool scanned = scanPayrollEntries(openPeriods.front().startDate, lastEnd, [&](const TimeEntry& entry) {
+        auto next = std::upper_bound(periodStarts.begin(), periodStarts.end(), entry.dateWorked.days);
+        size_t periodIndex = static_cast<size_t>(next - periodStarts.begin()) - 1;
+        if (entry.dateWorked > openPeriods[periodIndex].endDate)
+            return true; // Falls in a gap between open periods
+
+        auto emp = employeeIndex.find(entry.employeeID);
+        if (emp == employeeIndex.end())
+            return true; // Inactive employee
+
+        calculators[periodIndex].addEntry(hours[periodIndex * employees.size() + emp->second], entry.dateWorked, entry.hoursWorked, entry.shiftStart);
+        return true;
+    });
+
+    if (!scanned)
+        return rollback();
+
+    // ------------------------------------------------------------ //
+    // Writing every (period, employee) payroll row in this transaction //
+    // ------------------------------------------------------------ //
+
+    const char* insertPayrollSQL = "INSERT INTO payroll (employee_id, pay_period_id, gross_pay, net_pay, tax, hours_worked) VALUES (?, ?, ?, ?, ?, ?);";
+    const char* updateSQL = "UPDATE pay_periods SET processed_at = CURRENT_TIMESTAMP WHERE id = ?;";
+
+    sqlite3_stmt* insertPayrollStmt;
+    sqlite3_stmt* ytdStmt;
+    sqlite3_stmt* updateStmt;
+
+    if (sqlite3_prepare_v2(db, insertPayrollSQL, -1, &insertPayrollStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    if (sqlite3_prepare_v2(db, payrollYtdUpsertSQL, -1, &ytdStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(insertPayrollStmt);
+        return rollback();
+    }
+
+    if (sqlite3_prepare_v2(db, updateSQL, -1, &updateStmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(insertPayrollStmt);
+        sqlite3_finalize(ytdStmt);
+        return rollback();
+    }
+
+    std::vector<AppliedDeduction> appliedDeductions;
+
+    bool success{ true };
+    for (size_t periodIndex = 0; success && periodIndex < openPeriods.size(); periodIndex++) {
+        const PayPeriod& period = openPeriods[periodIndex];
+        const PayCalculator& calculator = calculators[periodIndex];
+        int payYear = period.endDate.year();
+
+        for (size_t employee = 0; success && employee < employees.size(); employee++) {
+            const ActiveEmployee& emp = employees[employee];
+            PayResult pay = calculator.calculate(hours[periodIndex * employees.size() + employee], emp.hourlyRate, emp.taxTable,
+                deductions.forEmployee(employee), deductions.countFor(employee));
+            deductions.collect(employee, emp.id, appliedDeductions);
+
+            sqlite3_bind_int(insertPayrollStmt, 1, emp.id);
+            sqlite3_bind_int(insertPayrollStmt, 2, period.id);
+            sqlite3_bind_double(insertPayrollStmt, 3, pay.grossPay);
+            sqlite3_bind_double(insertPayrollStmt, 4, pay.netPay);
+            sqlite3_bind_double(insertPayrollStmt, 5, pay.tax);
+            sqlite3_bind_double(insertPayrollStmt, 6, pay.hoursWorked);
+
+            int insertResult = sqlite3_step(insertPayrollStmt);
+            sqlite3_reset(insertPayrollStmt);
+
+            if (insertResult != SQLITE_DONE) {
+                std::cerr << "\nFailed to insert payroll for employee ID " << emp.id << ": " << sqlite3_errmsg(db) << '\n';
+                success = false;
+                break;
+            }
+
+            success = addToPayrollYtd(ytdStmt, emp.id, payYear, pay);
+            if (!success)
+                break;
+
+            recordsWritten++;
+        }
+
+        if (!success || !recordDeductions(period.id, appliedDeductions)
+            || !refreshDepartmentTotals(period.id) || !clearTimeEntryChanges(period.startDate, period.endDate)) {
+            success = false;
+            break;
+        }
+
+        appliedDeductions.clear();
+
+        sqlite3_bind_int(updateStmt, 1, period.id);
+        int updateResult = sqlite3_step(updateStmt);
+        sqlite3_reset(updateStmt);
+
+        if (updateResult != SQLITE_DONE) {
+            std::cerr << "\nFailed to mark pay period as processed: " << sqlite3_errmsg(db) << '\n';
+            success = false;
+            break;
+        }
+
+        periodsProcessed++;
+    }
+
+    sqlite3_finalize(insertPayrollStmt);
+    sqlite3_finalize(ytdStmt);
+    sqlite3_finalize(updateStmt);
+
+    if (!success) {
+        periodsProcessed = 0;
+        recordsWritten = 0;
+        return rollback();
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to commit payroll: " << sqlite3_errmsg(db) << '\n';
+        periodsProcessed = 0;
+        recordsWritten = 0;
+        return rollback();
+    }
+
+    return true;
+}
+
+bool Database::clearTimeEntryChanges(const Date& startDate, const Date& endDate) {
+    const char* SQL = "DELETE FROM time_entry_changes WHERE date_worked BETWEEN ? AND ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, startDate.days);
+    sqlite3_bind_int(stmt, 2, endDate.days);
+
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "\nFailed to clear time entry changes: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+// Where an interrupted run of the period stopped, lastEmployeeID stays 0 when there is nothing to resume //
+bool Database::getPayrollRunCheckpoint(const int& payPeriodID, int& lastEmployeeID, int& employeesDone) {
+    const char* SQL = "SELECT last_employee_id, employees_done FROM payroll_runs WHERE pay_period_id = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+
+    lastEmployeeID = 0;
+    employeesDone = 0;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        lastEmployeeID = sqlite3_column_int(stmt, 0);
+        employeesDone = sqlite3_column_int(stmt, 1);
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+// Re-aggregates one period's payroll rows into the department cube, inside the caller's transaction //
+bool Database::refreshDepartmentTotals(const int& payPeriodID) {
+    const char* deleteSQL = "DELETE FROM payroll_department_totals WHERE pay_period_id = ?;";
+    const char* insertSQL = "INSERT INTO payroll_department_totals "
+        "(pay_period_id, department_id, employee_count, hours_worked, gross_pay, tax, net_pay) "
+        "SELECT pr.pay_period_id, COALESCE(e.department_id, 0), COUNT(*), "
+        "SUM(pr.hours_worked), SUM(pr.gross_pay), SUM(pr.tax), SUM(pr.net_pay) "
+        "FROM payroll pr JOIN employees e ON e.id = pr.employee_id "
+        "WHERE pr.pay_period_id = ? "
+        "GROUP BY pr.pay_period_id, COALESCE(e.department_id, 0);";
+
+    for (const char* SQL : { deleteSQL, insertSQL }) {
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+            return false;
+        }
+
+        sqlite3_bind_int(stmt, 1, payPeriodID);
+
+        int result = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+
+        if (result != SQLITE_DONE) {
+            std::cerr << "\nFailed to update department totals: " << sqlite3_errmsg(db) << '\n';
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Database::addTimeEntry(const TimeEntry& timeEntry) {
+    if (isArchived(timeEntry.dateWorked)) {
+        std::cerr << "\nFailed: " << timeEntry.dateWorked.year() << " is closed and its time entries are archived.\n";
+        return false;
+    }
+
+    const char* SQL = "INSERT INTO time_entries (employee_id, date_worked, hours_worked, shift_start) VALUES (?, ?, ?, ?);";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, timeEntry.employeeID);
+    sqlite3_bind_int(stmt, 2, timeEntry.dateWorked.days);
+    sqlite3_bind_double(stmt, 3, timeEntry.hoursWorked);
+    if (timeEntry.shiftStart >= 0)
+        sqlite3_bind_int(stmt, 4, timeEntry.shiftStart);
+
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        int errorCode = sqlite3_extended_errcode(db);
+
+        switch (errorCode) {
+        case SQLITE_CONSTRAINT_FOREIGNKEY:
+            std::cerr << "\nFailed: Employee ID does not exist.\n";
+            break;
+        case SQLITE_CONSTRAINT_NOTNULL:
+            std::cerr << "\nFailed: Missing required value (NULL not allowed).\n";
+            break;
+        case SQLITE_CONSTRAINT_CHECK:
+            std::cerr << "\nFailed: Check constraint violated (e.g., negative hours).\n";
+            break;
+        case SQLITE_CONSTRAINT_UNIQUE:
+            std::cerr << "\nFailed: Duplicate entry where unique value required.\n";
+            break;
+        default:
+            std::cerr << "\nFailed to add time entry: " << sqlite3_errmsg(db) << '\n';
+        }
+
+        return false;
+    }
+
+    return true;
+}
+
+// Yearly archives sit next to the main database, eg. payroll_management_system_time_entries_2024.db //
+std::string Database::archiveFileName(int year) const {
+    std::string baseName = databaseFile;
+    if (baseName.size() > 3 && baseName.compare(baseName.size() - 3, 3, ".db") == 0)
+        baseName.erase(baseName.size() - 3);
+
+    return baseName + "_time_entries_" + std::to_string(year) + ".db";
+}
+
+bool Database::isArchived(const Date& dateWorked) const {
+    return !timeEntryArchives.empty() && timeEntryArchives.count(dateWorked.year()) != 0;
+}
+
+bool Database::attachArchive(int year, const std::string& fileName) {
+    if (attachedArchives.count(year) != 0)
+        return true;
+
+    std::string SQL = "ATTACH DATABASE ? AS archive_" + std::to_string(year) + ";";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_text(stmt, 1, fileName.c_str(), -1, SQLITE_TRANSIENT);
+
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "\nFailed to attach time entry archive " << fileName << ": " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    attachedArchives.insert(year);
+    return true;
+}
+
+// Attaches the archive of every archived year the range reaches into, must be called outside a transaction. //
+// SQLite allows 10 attached databases by default, so years outside the range are detached once 8 are open    //
+bool Database::attachArchives(const Date& startDate, const Date& endDate) {
+    if (timeEntryArchives.empty())
+        return true;
+
+    const size_t maxAttachedArchives{ 8 };
+    int firstYear = startDate.year();
+    int lastYear = endDate.year();
+
+    for (int year = firstYear; year <= lastYear; year++) {
+        auto archive = timeEntryArchives.find(year);
+        if (archive == timeEntryArchives.end() || attachedArchives.count(year) != 0)
+            continue;
+
+        if (attachedArchives.size() >= maxAttachedArchives) {
+            for (auto attached = attachedArchives.begin(); attached != attachedArchives.end();) {
+                if (*attached >= firstYear && *attached <= lastYear) {
+                    ++attached;
+                    continue;
+                }
+
+                std::string detachSQL = "DETACH DATABASE archive_" + std::to_string(*attached) + ";";
+                sqlite3_exec(db, detachSQL.c_str(), nullptr, nullptr, nullptr);
+                attached = attachedArchives.erase(attached);
+            }
+        }
+
+        if (!attachArchive(year, archive->second.fileName))
+            return false;
+    }
+
+    return true;
+}
+
+// Moves a closed year's time entries into its own database file. The copy and the delete share one write //
+// transaction, so no entry can be written in between, and only rows found in the archive are deleted.    //
+// Archiving the year again replaces the copies. Payroll rows and totals stay in the main database        //
+bool Database::archiveTimeEntries(const int& year, int& entriesMoved) {
+    entriesMoved = 0;
+
+    Date firstDay = Date::fromCivil(year, 1, 1);
+    Date lastDay = Date::fromCivil(year, 12, 31);
+
+    if (year >= Date::today().year()) {
+        std::cerr << "\nOnly years that have ended can be archived\n";
+        return false;
+    }
+
+    // A year is closed once every pay period touching it is processed and no late change waits for reprocessing //
+    const char* openSQL = "SELECT "
+        "(SELECT COUNT(*) FROM pay_periods WHERE processed_at IS NULL AND start_date <= ?2 AND end_date >= ?1), "
+        "(SELECT COUNT(*) FROM time_entry_changes WHERE date_worked BETWEEN ?1 AND ?2);";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, openSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, firstDay.days);
+    sqlite3_bind_int(stmt, 2, lastDay.days);
+
+    int openPeriods{ 0 }, pendingChanges{ 0 };
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+        openPeriods = sqlite3_column_int(stmt, 0);
+        pendingChanges = sqlite3_column_int(stmt, 1);
+    }
+    sqlite3_finalize(stmt);
+
+    if (openPeriods > 0) {
+        std::cerr << "\n" << year << " still has " << openPeriods << " unprocessed pay period(s)\n";
+        return false;
+    }
+
+    if (pendingChanges > 0) {
+        std::cerr << "\n" << year << " has " << pendingChanges << " time entry change(s) waiting to be reprocessed\n";
+        return false;
+    }
+
+    auto existing = timeEntryArchives.find(year);
+    std::string fileName = existing != timeEntryArchives.end() ? existing->second.fileName : archiveFileName(year);
+    std::string schema = "archive_" + std::to_string(year);
+
+    if (!attachArchive(year, fileName))
+        return false;
+
+    // Same columns as time_entries, the foreign key stays behind since it cannot reach the main database //
+    std::string createSQL =
+        "CREATE TABLE IF NOT EXISTS " + schema + ".time_entries ("
+        "id INTEGER PRIMARY KEY, "
+        "employee_id INTEGER NOT NULL, "
+        "date_worked INTEGER NOT NULL, "
+        "hours_worked REAL NOT NULL, "
+        "shift_start INTEGER, "
+        "UNIQUE(employee_id, date_worked)); "
+        "CREATE INDEX IF NOT EXISTS " + schema + ".idx_time_entries_pay ON time_entries (date_worked, employee_id, hours_worked, shift_start);";
+
+    if (sqlite3_exec(db, createSQL.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to create time entry archive " << fileName << ": " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    auto rollback = [this]() {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    };
+
+    // The delete trigger logs every moved entry as a late change, those rows are cleared in the same transaction //
+    std::string copySQL = "INSERT OR REPLACE INTO " + schema + ".time_entries (id, employee_id, date_worked, hours_worked, shift_start) "
+        "SELECT id, employee_id, date_worked, hours_worked, shift_start FROM main.time_entries WHERE date_worked BETWEEN ?1 AND ?2;";
+    std::string deleteSQL = "DELETE FROM main.time_entries WHERE date_worked BETWEEN ?1 AND ?2 "
+        "AND id IN (SELECT id FROM " + schema + ".time_entries WHERE date_worked BETWEEN ?1 AND ?2);";
+    const char* clearChangesSQL = "DELETE FROM time_entry_changes WHERE date_worked BETWEEN ?1 AND ?2;";
+    std::string registerSQL = "INSERT INTO time_entry_archives (year, file_name, entry_count) "
+        "VALUES (?3, ?4, (SELECT COUNT(*) FROM " + schema + ".time_entries)) "
+        "ON CONFLICT(year) DO UPDATE SET entry_count = excluded.entry_count, archived_at = CURRENT_TIMESTAMP;";
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start archive transaction: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    for (const std::string& statementSQL : { copySQL, deleteSQL, std::string(clearChangesSQL), registerSQL }) {
+        if (sqlite3_prepare_v2(db, statementSQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+            return rollback();
+        }
+
+        sqlite3_bind_int(stmt, 1, firstDay.days);
+        sqlite3_bind_int(stmt, 2, lastDay.days);
+        if (sqlite3_bind_parameter_count(stmt) >= 4) {
+            sqlite3_bind_int(stmt, 3, year);
+            sqlite3_bind_text(stmt, 4, fileName.c_str(), -1, SQLITE_TRANSIENT);
+        }
+
+        int result = sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+
+        if (result != SQLITE_DONE) {
+            std::cerr << "\nFailed to archive time entries: " << sqlite3_errmsg(db) << '\n';
+            return rollback();
+        }
+
+        if (statementSQL == deleteSQL)
+            entriesMoved = sqlite3_changes(db);
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to commit archived time entries: " << sqlite3_errmsg(db) << '\n';
+        return rollback();
+    }
+
+    if (!loadTimeEntryArchives())
+        return false;
+
+    // Hands the freed pages back so the main file actually shrinks //
+    if (sqlite3_exec(db, "VACUUM main;", nullptr, nullptr, nullptr) != SQLITE_OK)
+        std::cerr << "\nTime entries archived, but compacting the database failed: " << sqlite3_errmsg(db) << '\n';
+
+    return true;
+}
+
+std::vector<TimeEntryArchive> Database::getTimeEntryArchives() const {
+    std::vector<TimeEntryArchive> archives;
+    for (const auto& archive : timeEntryArchives)
+        archives.push_back(archive.second);
+
+    return archives;
+}
+
+bool Database::importTimeEntries(const std::string& fileName, bool upsert, const std::string& rejectFileName, ImportSummary& summary) {
+    const int batchSize = 50000;
+
+    TimeClockReader reader;
+    if (!reader.open(fileName)) {
+        std::cerr << "\nFailed to open import file: " << fileName << '\n';
+        return false;
+    }
+
+    // upsert = later punches for the same employee and day replace the stored hours //
+    // otherwise conflicting lines are written to the reject file untouched           //
+    const char* SQL = upsert
+        ? "INSERT INTO time_entries (employee_id, date_worked, hours_worked, shift_start) VALUES (?, ?, ?, ?) "
+          "ON CONFLICT(employee_id, date_worked) DO UPDATE SET hours_worked = excluded.hours_worked, shift_start = excluded.shift_start;"
+        : "INSERT INTO time_entries (employee_id, date_worked, hours_worked, shift_start) VALUES (?, ?, ?, ?);";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    // A line is only counted as rejected once it reached the reject file, the import stops when it cannot //
+    // be written. Each batch flushes the file before committing, so no committed batch loses its rejects  //
+    std::ofstream rejectFile;
+    auto rejectLine = [&](const char* line, size_t length) {
+        if (!rejectFile.is_open())
+            rejectFile.open(rejectFileName, std::ios::binary);
+
+        if (rejectFile.is_open()) {
+            rejectFile.write(line, static_cast<std::streamsize>(length));
+            rejectFile.put('\n');
+        }
+
+        if (!rejectFile.is_open() || !rejectFile) {
+            std::cerr << "\nFailed to write line " << reader.getLineNumber() << " to the reject file " << rejectFileName << '\n';
+            return false;
+        }
+
+        summary.rejected++;
+        return true;
+    };
+
+    auto flushRejects = [&]() {
+        if (rejectFile.is_open() && !rejectFile.flush()) {
+            std::cerr << "\nFailed to write the reject file " << rejectFileName << '\n';
+            return false;
+        }
+
+        return true;
+    };
+
+    TimeEntry entry;
+    const char* line;
+    size_t length;
+    long long pendingRows{ 0 };
+    bool success{ true };
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to start import transaction: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_finalize(stmt);
+        return false;
+    }
+
+    TimeClockReader::Status status;
+    while ((status = reader.next(entry, line, length)) != TimeClockReader::Status::End) {
+        // Closed years are archived, their entries can no longer change //
+        if (status == TimeClockReader::Status::Invalid || isArchived(entry.dateWorked)) {
+            if (!rejectLine(line, length)) {
+                success = false;
+                break;
+            }
+
+            continue;
+        }
+
+        sqlite3_bind_int(stmt, 1, entry.employeeID);
+        sqlite3_bind_int(stmt, 2, entry.dateWorked.days);
+        sqlite3_bind_double(stmt, 3, entry.hoursWorked);
+        if (entry.shiftStart >= 0)
+            sqlite3_bind_int(stmt, 4, entry.shiftStart);
+        else
+            sqlite3_bind_null(stmt, 4);
+
+        int result = sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+
+        if (result == SQLITE_DONE) {
+            pendingRows++;
+        }
+        else if ((sqlite3_extended_errcode(db) & 0xff) == SQLITE_CONSTRAINT) {
+            if (!rejectLine(line, length)) {
+                success = false;
+                break;
+            }
+        }
+        else {
+            std::cerr << "\nImport failed on line " << reader.getLineNumber() << ": " << sqlite3_errmsg(db) << '\n';
+            success = false;
+            break;
+        }
+
+        if (pendingRows == batchSize) {
+            if (!flushRejects()) {
+                success = false;
+                break;
+            }
+
+            if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                std::cerr << "\nFailed to commit imported time entries: " << sqlite3_errmsg(db) << '\n';
+                success = false;
+                break;
+            }
+
+            summary.imported += pendingRows;
+            summary.batches++;
+            pendingRows = 0;
+
+            if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+                std::cerr << "\nFailed to start import transaction: " << sqlite3_errmsg(db) << '\n';
+                sqlite3_finalize(stmt);
+                return false;
+            }
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (!success || !flushRejects()) {
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    if (sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to commit imported time entries: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    summary.imported += pendingRows;
+    summary.batches += pendingRows > 0;
+
+    return true;
+}
+
+bool Database::setEmployeeStatus(const int& employeeID, const bool& isActive) {
+    const char* SQL = "UPDATE employees SET is_active = ? WHERE id = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, isActive ? 1 : 0);
+    sqlite3_bind_int(stmt, 2, employeeID);
+
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "\nError Setting Employee Status: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    if (sqlite3_changes(db) == 0) {
+        std::cout << "\nFailed To Set Employee Status: Please verify employee ID exists and try again\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool Database::addEmployee(const Employee& emp) {
+    const char* SQL = "INSERT INTO employees (first_name, last_name, department_id, employment_type_id, hourly_rate, hire_date, is_active, jurisdiction, filing_status) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
+    
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
 
-        sqlite3_bind_int(insertPayrollStmt, 1, employeeID);
-        sqlite3_bind_int(insertPayrollStmt, 2, payPeriodID);
-        sqlite3_bind_double(insertPayrollStmt, 3, grossPay);
-        sqlite3_bind_double(insertPayrollStmt, 4, netPay);
+    sqlite3_bind_text(stmt, 1, emp.firstName.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 2, emp.lastName.c_str(), -1, SQLITE_TRANSIENT);
+    // Id 0 is left unbound, which stores NULL //
+    if (emp.departmentID > 0)
+        sqlite3_bind_int(stmt, 3, emp.departmentID);
 
-        int insertPayrollResult = sqlite3_step(insertPayrollStmt);
-        sqlite3_finalize(insertPayrollStmt);
+    if (emp.employmentTypeID > 0)
+        sqlite3_bind_int(stmt, 4, emp.employmentTypeID);
 
-        if (insertPayrollResult != SQLITE_DONE) {
-            std::cerr << "\nFailed to insert payroll: " << sqlite3_errmsg(db) << '\n';
-            sqlite3_finalize(employeesStmt);
-            return false;
-        }
+    sqlite3_bind_double(stmt, 5, emp.hourlyRate);
+    sqlite3_bind_int(stmt, 6, emp.hireDate.days);
+    sqlite3_bind_int(stmt, 7, emp.isActive ? 1 : 0);
+    sqlite3_bind_text(stmt, 8, emp.jurisdiction.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 9, emp.filingStatus.c_str(), -1, SQLITE_TRANSIENT);
 
-        std::cout << "Payroll Inserted Successfully for Employee ID: " << employeeID << '\n';
-        std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
+    int result = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "\nFailed To Add Employee, Error: " << sqlite3_errmsg(db) << '\n';
+        return false;
     }
 
-    sqlite3_finalize(employeesStmt);
+    employeeNameIndex.add(static_cast<int>(sqlite3_last_insert_rowid(db)), emp.firstName, emp.lastName, departments.name(emp.departmentID));
+    return true;
+}
 
-    if (employeeCount == 0)
-        std::cout << "\nNo active employees found for this pay period\n";
-    else
-        std::cout << "\nPayroll processing completed for " << employeeCount << " employees(s)" << '\n';
+// Streams the best matches of a name / department search, looked up in the in-memory index and read back //
+// by primary key. Returns the row count (-1 on error)                                                  //
+int Database::searchEmployees(const std::string& query, int limit, const RowVisitor<Employee>& visitor) {
+    std::vector<int> employeeIDs;
+    employeeNameIndex.search(query, limit > 0 ? static_cast<size_t>(limit) : 0, employeeIDs);
+    if (employeeIDs.empty())
+        return 0;
 
-    // ------------------------------- //
-    // Marking pay period as processed //
-    // ------------------------------- //
+    const char* SQL = "SELECT id, first_name, last_name, department_id, employment_type_id, hire_date, hourly_rate, is_active "
+        "FROM employees WHERE id = ?;";
 
-    const char* updateSQL = "UPDATE pay_periods SET processed_at = CURRENT_TIMESTAMP WHERE id = ?;";
-    sqlite3_stmt* updateStmt;
-    if (sqlite3_prepare_v2(db, updateSQL, -1, &updateStmt, nullptr) != SQLITE_OK) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return false;
+        return -1;
     }
 
-    sqlite3_bind_int(updateStmt, 1, payPeriodID);
-
-    int updateResult = sqlite3_step(updateStmt);
-    sqlite3_finalize(updateStmt);
+    Employee emp;
+    int rowCount{ 0 };
+
+    for (int employeeID : employeeIDs) {
+        sqlite3_bind_int(stmt, 1, employeeID);
+
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            emp.id = sqlite3_column_int(stmt, 0);
+            emp.firstName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            emp.lastName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+            emp.departmentID = sqlite3_column_int(stmt, 3);
+            emp.employmentTypeID = sqlite3_column_int(stmt, 4);
+            emp.hireDate.days = sqlite3_column_int(stmt, 5);
+            emp.hourlyRate = sqlite3_column_double(stmt, 6);
+            emp.isActive = sqlite3_column_int(stmt, 7);
+
+            rowCount++;
+            if (!visitor(emp))
+                break;
+        }
 
-    if (updateResult != SQLITE_DONE) {
-        std::cerr << "\nFailed to mark pay period as processed: " << sqlite3_errmsg(db) << '\n';
-        return false;
+        sqlite3_reset(stmt);
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(consoleWaitTimer));
-    std::cout << "Pay period successfully marked as processed\n";
-
-    return true;
+    sqlite3_finalize(stmt);
+    return rowCount;
 }
 
-bool Database::addTimeEntry(const TimeEntry& timeEntry) {
-    const char* SQL = "INSERT INTO time_entries (employee_id, date_worked, hours_worked) VALUES (?, ?, ?);";
+bool Database::addDeduction(const Deduction& deduction) {
+    const char* SQL = "INSERT INTO deductions (employee_id, kind, name, pre_tax, percent, amount, period_cap, total_cap, is_active) "
+        "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?);";
+
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
-    sqlite3_bind_int(stmt, 1, timeEntry.employeeID);
-    sqlite3_bind_text(stmt, 2, timeEntry.dateWorked.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_double(stmt, 3, timeEntry.hoursWorked);
+    sqlite3_bind_int(stmt, 1, deduction.employeeID);
+    sqlite3_bind_text(stmt, 2, deduction.kind.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt, 3, deduction.name.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 4, deduction.preTax ? 1 : 0);
+    sqlite3_bind_double(stmt, 5, deduction.percent);
+    sqlite3_bind_double(stmt, 6, deduction.amount);
+    sqlite3_bind_double(stmt, 7, deduction.periodCap);
+    sqlite3_bind_double(stmt, 8, deduction.totalCap);
+    sqlite3_bind_int(stmt, 9, deduction.isActive ? 1 : 0);
 
     int result = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
     if (result != SQLITE_DONE) {
-        int errorCode = sqlite3_extended_errcode(db);
-
-        switch (errorCode) {
-        case SQLITE_CONSTRAINT_FOREIGNKEY:
-            std::cerr << "\nFailed: Employee ID does not exist.\n";
-            break;
-        case SQLITE_CONSTRAINT_NOTNULL:
-            std::cerr << "\nFailed: Missing required value (NULL not allowed).\n";
-            break;
-        case SQLITE_CONSTRAINT_CHECK:
-            std::cerr << "\nFailed: Check constraint violated (e.g., negative hours).\n";
-            break;
-        case SQLITE_CONSTRAINT_UNIQUE:
-            std::cerr << "\nFailed: Duplicate entry where unique value required.\n";
-            break;
-        default:
-            std::cerr << "\nFailed to add time entry: " << sqlite3_errmsg(db) << '\n';
-        }
-
+        std::cerr << "\nFailed To Add Deduction, Error: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
     return true;
 }
 
-bool Database::setEmployeeStatus(const int& employeeID, const bool& isActive) {
-    const char* SQL = "UPDATE employees SET is_active = ? WHERE id = ?;";
+bool Database::setDeductionStatus(const int& deductionID, const bool& isActive) {
+    const char* SQL = "UPDATE deductions SET is_active = ? WHERE id = ?;";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
@@ -334,53 +2081,196 @@ bool Database::setEmployeeStatus(const int& employeeID, const bool& isActive) {
     }
 
     sqlite3_bind_int(stmt, 1, isActive ? 1 : 0);
-    sqlite3_bind_int(stmt, 2, employeeID);
+    sqlite3_bind_int(stmt, 2, deductionID);
 
     int result = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
 
     if (result != SQLITE_DONE) {
-        std::cerr << "\nError Setting Employee Status: " << sqlite3_errmsg(db) << '\n';
+        std::cerr << "\nError Setting Deduction Status: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
     if (sqlite3_changes(db) == 0) {
-        std::cout << "\nFailed To Set Employee Status: Please verify employee ID exists and try again\n";
+        std::cout << "\nFailed To Set Deduction Status: Please verify deduction ID exists and try again\n";
         return false;
     }
 
     return true;
 }
 
-bool Database::addEmployee(const Employee& emp) {
-    const char* SQL = "INSERT INTO employees (first_name, last_name, department, employment_type, hourly_rate, hire_date, is_active) "
-        "VALUES (?, ?, ?, ?, ?, ?, ?);";
-    
+std::vector<Deduction> Database::getEmployeeDeductions(const int& employeeID) {
+    std::vector<Deduction> deductions;
+
+    const char* SQL = "SELECT id, kind, name, pre_tax, percent, amount, period_cap, total_cap, deducted_total, is_active "
+        "FROM deductions WHERE employee_id = ? ORDER BY id;";
     sqlite3_stmt* stmt;
     if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return false;
+        return deductions;
     }
 
-    sqlite3_bind_text(stmt, 1, emp.firstName.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, emp.lastName.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 3, emp.department.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 4, emp.employmentType.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_double(stmt, 5, emp.hourlyRate);
-    sqlite3_bind_text(stmt, 6, emp.hireDate.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 7, emp.isActive ? 1 : 0);
+    sqlite3_bind_int(stmt, 1, employeeID);
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        Deduction deduction;
+        deduction.id = sqlite3_column_int(stmt, 0);
+        deduction.employeeID = employeeID;
+        deduction.kind = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        deduction.name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        deduction.preTax = sqlite3_column_int(stmt, 3) != 0;
+        deduction.percent = sqlite3_column_double(stmt, 4);
+        deduction.amount = sqlite3_column_double(stmt, 5);
+        deduction.periodCap = sqlite3_column_double(stmt, 6);
+        deduction.totalCap = sqlite3_column_double(stmt, 7);
+        deduction.deductedTotal = sqlite3_column_double(stmt, 8);
+        deduction.isActive = sqlite3_column_int(stmt, 9) != 0;
+
+        deductions.push_back(deduction);
+    }
 
-    int result = sqlite3_step(stmt);
     sqlite3_finalize(stmt);
+    return deductions;
+}
 
-    if (result != SQLITE_DONE) {
-        std::cerr << "\nFailed To Add Employee, Error: " << sqlite3_errmsg(db) << '\n';
+// Loads the active deductions of a run's employees in one ordered pass. employeeIDs must be sorted   //
+// ascending, rows for employees outside the run are skipped while merging. A deduction already       //
+// taken in payPeriodID stays in when it was deactivated later, so reprocessing keeps what was paid.  //
+// The cap room only counts periods ending before payPeriodID: what later periods took is split off   //
+// from the running total by reading their detail rows, which are few unless an old period is redone  //
+bool Database::loadDeductions(const int& payPeriodID, const std::vector<int>& employeeIDs, DeductionTable& table) {
+    const char* SQL = "SELECT d.employee_id, d.id, d.pre_tax, d.percent, d.amount, d.period_cap, d.total_cap, "
+        "d.deducted_total - COALESCE(later.amount, 0), COALESCE(later.amount, 0) - COALESCE(pd.amount, 0), pd.amount IS NOT NULL "
+        "FROM deductions d LEFT JOIN payroll_deductions pd ON pd.pay_period_id = ?1 AND pd.deduction_id = d.id "
+        "LEFT JOIN (SELECT pd2.deduction_id, SUM(pd2.amount) AS amount FROM pay_periods p2 "
+        "JOIN payroll_deductions pd2 ON pd2.pay_period_id = p2.id "
+        "WHERE p2.end_date >= (SELECT end_date FROM pay_periods WHERE id = ?1) GROUP BY pd2.deduction_id) later "
+        "ON later.deduction_id = d.id "
+        "WHERE d.is_active = 1 OR pd.amount IS NOT NULL ORDER BY d.employee_id, d.id;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
         return false;
     }
 
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+
+    table.rules.clear();
+    table.first.assign(1, 0);
+    size_t employee{ 0 };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        int employeeID = sqlite3_column_int(stmt, 0);
+
+        while (employee < employeeIDs.size() && employeeIDs[employee] < employeeID) {
+            table.first.push_back(table.rules.size());
+            employee++;
+        }
+
+        if (employee == employeeIDs.size())
+            break;
+
+        if (employeeIDs[employee] != employeeID)
+            continue;
+
+        DeductionRule rule;
+        rule.id = sqlite3_column_int(stmt, 1);
+        rule.preTax = sqlite3_column_int(stmt, 2) != 0;
+        rule.percent = sqlite3_column_double(stmt, 3);
+        rule.amount = sqlite3_column_double(stmt, 4);
+        rule.periodCap = sqlite3_column_double(stmt, 5);
+        rule.totalCap = sqlite3_column_double(stmt, 6);
+        rule.deductedTotal = sqlite3_column_double(stmt, 7);
+        rule.laterTotal = sqlite3_column_double(stmt, 8);
+        rule.recorded = sqlite3_column_int(stmt, 9) != 0;
+
+        table.rules.push_back(rule);
+    }
+    sqlite3_finalize(stmt);
+
+    for (; employee < employeeIDs.size(); employee++)
+        table.first.push_back(table.rules.size());
+
     return true;
 }
 
+// Writes the detail rows and the new running totals with multi-row statements of up to 100 rows, //
+// the caller owns the transaction                                                                 //
+bool Database::recordDeductions(const int& payPeriodID, const std::vector<AppliedDeduction>& rows) {
+    const size_t batchRows{ 100 };
+
+    auto insertSQL = [](size_t count) {
+        std::string SQL = "INSERT INTO payroll_deductions (pay_period_id, deduction_id, employee_id, amount) VALUES ";
+        for (size_t i = 0; i < count; i++)
+            SQL += i == 0 ? "(?, ?, ?, ?)" : ", (?, ?, ?, ?)";
+
+        return SQL + " ON CONFLICT(pay_period_id, deduction_id) DO UPDATE SET amount = excluded.amount;";
+    };
+
+    auto updateSQL = [](size_t count) {
+        std::string SQL = "UPDATE deductions SET deducted_total = v.column2 FROM (VALUES ";
+        for (size_t i = 0; i < count; i++)
+            SQL += i == 0 ? "(?, ?)" : ", (?, ?)";
+
+        return SQL + ") AS v WHERE deductions.id = v.column1;";
+    };
+
+    sqlite3_stmt* insertStmt{ nullptr };
+    sqlite3_stmt* updateStmt{ nullptr };
+    size_t preparedRows{ 0 };
+    bool success{ true };
+
+    for (size_t batchStart = 0; success && batchStart < rows.size(); batchStart += batchRows) {
+        size_t count = std::min(batchRows, rows.size() - batchStart);
+
+        // Full batches reuse the same statements, only the last partial batch needs its own //
+        if (count != preparedRows) {
+            sqlite3_finalize(insertStmt);
+            sqlite3_finalize(updateStmt);
+            insertStmt = nullptr;
+            updateStmt = nullptr;
+            preparedRows = count;
+
+            if (sqlite3_prepare_v2(db, insertSQL(count).c_str(), -1, &insertStmt, nullptr) != SQLITE_OK
+                || sqlite3_prepare_v2(db, updateSQL(count).c_str(), -1, &updateStmt, nullptr) != SQLITE_OK) {
+                std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+                success = false;
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            const AppliedDeduction& row = rows[batchStart + i];
+            int insertParameter = static_cast<int>(i) * 4;
+            int updateParameter = static_cast<int>(i) * 2;
+
+            sqlite3_bind_int(insertStmt, insertParameter + 1, payPeriodID);
+            sqlite3_bind_int(insertStmt, insertParameter + 2, row.deductionID);
+            sqlite3_bind_int(insertStmt, insertParameter + 3, row.employeeID);
+            sqlite3_bind_double(insertStmt, insertParameter + 4, row.amount);
+
+            sqlite3_bind_int(updateStmt, updateParameter + 1, row.deductionID);
+            sqlite3_bind_double(updateStmt, updateParameter + 2, row.deductedTotal);
+        }
+
+        for (sqlite3_stmt* stmt : { insertStmt, updateStmt }) {
+            int result = sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+
+            if (result != SQLITE_DONE) {
+                std::cerr << "\nFailed to record deductions: " << sqlite3_errmsg(db) << '\n';
+                success = false;
+                break;
+            }
+        }
+    }
+
+    sqlite3_finalize(insertStmt);
+    sqlite3_finalize(updateStmt);
+    return success;
+}
+
 std::vector<PayPeriod> Database::getPayPeriods() {
     std::vector<PayPeriod> stored_pay_periods;
 
@@ -395,8 +2285,8 @@ std::vector<PayPeriod> Database::getPayPeriods() {
         PayPeriod payPeriod;
 
         payPeriod.id = sqlite3_column_int(stmt, 0);
-        payPeriod.startDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        payPeriod.endDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        payPeriod.startDate.days = sqlite3_column_int(stmt, 1);
+        payPeriod.endDate.days = sqlite3_column_int(stmt, 2);
         payPeriod.processedAt = sqlite3_column_text(stmt, 3) ? reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) : "";
 
         stored_pay_periods.push_back(payPeriod);
@@ -406,126 +2296,485 @@ std::vector<PayPeriod> Database::getPayPeriods() {
     return stored_pay_periods;
 }
 
-std::vector<Payroll> Database::getPayrollRecords() {
-    std::vector<Payroll> stored_payroll_records;
-
-    const char* SQL = "SELECT pr.employee_id, pr.pay_period_id, e.first_name, e.last_name, "
+// Pages are keyed on payroll's own (pay_period_id, employee_id) so idx_payroll_period seeks straight to the //
+// cursor. Names and dates are joined onto the page afterwards, sorting on them would re-sort every row      //
+int Database::getPayrollRecordsPage(PayrollCursor& cursor, int pageSize, const RowVisitor<Payroll>& visitor) {
+    const char* firstPageSQL = "SELECT pr.employee_id, pr.pay_period_id, e.first_name, e.last_name, "
         "p.start_date, p.end_date, pr.gross_pay, pr.net_pay "
-        "FROM payroll pr "
+        "FROM (SELECT employee_id, pay_period_id, gross_pay, net_pay FROM payroll "
+        "ORDER BY pay_period_id ASC, employee_id ASC LIMIT ?1) pr "
+        "JOIN pay_periods p ON pr.pay_period_id = p.id "
         "JOIN employees e ON pr.employee_id = e.id "
+        "ORDER BY pr.pay_period_id ASC, pr.employee_id ASC;";
+
+    const char* nextPageSQL = "SELECT pr.employee_id, pr.pay_period_id, e.first_name, e.last_name, "
+        "p.start_date, p.end_date, pr.gross_pay, pr.net_pay "
+        "FROM (SELECT employee_id, pay_period_id, gross_pay, net_pay FROM payroll "
+        "WHERE (pay_period_id, employee_id) > (?2, ?3) "
+        "ORDER BY pay_period_id ASC, employee_id ASC LIMIT ?1) pr "
         "JOIN pay_periods p ON pr.pay_period_id = p.id "
-        "ORDER BY p.start_date ASC, e.id ASC;";
+        "JOIN employees e ON pr.employee_id = e.id "
+        "ORDER BY pr.pay_period_id ASC, pr.employee_id ASC;";
 
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, cursor.atStart ? firstPageSQL : nextPageSQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return stored_payroll_records;
+        return -1;
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Payroll payrollRecord;
+    sqlite3_bind_int(stmt, 1, pageSize);
+    if (!cursor.atStart) {
+        sqlite3_bind_int(stmt, 2, cursor.payPeriodID);
+        sqlite3_bind_int(stmt, 3, cursor.employeeID);
+    }
 
+    Payroll payrollRecord;
+    int rowCount{ 0 };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         payrollRecord.employeeID = sqlite3_column_int(stmt, 0);
         payrollRecord.payPeriodID = sqlite3_column_int(stmt, 1);
         payrollRecord.firstName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
         payrollRecord.lastName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        payrollRecord.startDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        payrollRecord.endDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+        payrollRecord.startDate.days = sqlite3_column_int(stmt, 4);
+        payrollRecord.endDate.days = sqlite3_column_int(stmt, 5);
         payrollRecord.grossPay = sqlite3_column_double(stmt, 6);
         payrollRecord.netPay = sqlite3_column_double(stmt, 7);
 
-        stored_payroll_records.push_back(payrollRecord);
+        cursor.atStart = false;
+        cursor.payPeriodID = payrollRecord.payPeriodID;
+        cursor.employeeID = payrollRecord.employeeID;
+        rowCount++;
+
+        if (!visitor(payrollRecord))
+            break;
     }
 
     sqlite3_finalize(stmt);
-    return stored_payroll_records;
+    return rowCount;
 }
 
-std::vector<EmployeePayroll> Database::getEmployeePayrollHistory(const int& employeeID) {
-    std::vector<EmployeePayroll> stored_payrolls;
+int Database::getEmployeePayrollHistoryPage(const int& employeeID, EmployeePayrollCursor& cursor, int pageSize, const RowVisitor<EmployeePayroll>& visitor) {
+    const char* firstPageSQL = "SELECT pr.pay_period_id, "
+        "p.start_date, p.end_date, p.processed_at, "
+        "pr.gross_pay, pr.net_pay FROM payroll pr "
+        "JOIN pay_periods p ON pr.pay_period_id = p.id "
+        "WHERE pr.employee_id = ?2 "
+        "ORDER BY p.start_date ASC, pr.pay_period_id ASC LIMIT ?1;";
 
-    const char* SQL = "SELECT pr.pay_period_id, "
+    const char* nextPageSQL = "SELECT pr.pay_period_id, "
         "p.start_date, p.end_date, p.processed_at, "
         "pr.gross_pay, pr.net_pay FROM payroll pr "
         "JOIN pay_periods p ON pr.pay_period_id = p.id "
-        "WHERE pr.employee_id = ? ORDER BY p.start_date ASC;";
+        "WHERE pr.employee_id = ?2 AND (p.start_date, pr.pay_period_id) > (?3, ?4) "
+        "ORDER BY p.start_date ASC, pr.pay_period_id ASC LIMIT ?1;";
 
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, cursor.atStart ? firstPageSQL : nextPageSQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return stored_payrolls;
+        return -1;
     }
 
-    sqlite3_bind_int(stmt, 1, employeeID);
+    sqlite3_bind_int(stmt, 1, pageSize);
+    sqlite3_bind_int(stmt, 2, employeeID);
+    if (!cursor.atStart) {
+        sqlite3_bind_int(stmt, 3, cursor.startDate.days);
+        sqlite3_bind_int(stmt, 4, cursor.payPeriodID);
+    }
+
+    EmployeePayroll payroll;
+    int rowCount{ 0 };
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        EmployeePayroll payroll;
+        const unsigned char* processedAt = sqlite3_column_text(stmt, 3);
 
         payroll.payPeriodID = sqlite3_column_int(stmt, 0);
-        payroll.startDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        payroll.endDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        payroll.processedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+        payroll.startDate.days = sqlite3_column_int(stmt, 1);
+        payroll.endDate.days = sqlite3_column_int(stmt, 2);
+        payroll.processedAt = processedAt ? reinterpret_cast<const char*>(processedAt) : "";
         payroll.grossPay = sqlite3_column_double(stmt, 4);
         payroll.netPay = sqlite3_column_double(stmt, 5);
 
-        stored_payrolls.push_back(payroll);
+        cursor.atStart = false;
+        cursor.startDate = payroll.startDate;
+        cursor.payPeriodID = payroll.payPeriodID;
+        rowCount++;
+
+        if (!visitor(payroll))
+            break;
     }
 
     sqlite3_finalize(stmt);
-    return stored_payrolls;
+    return rowCount;
 }
 
-std::vector<TimeEntry> Database::getTimeEntries() {
-    std::vector<TimeEntry> stored_time_entries;
+int Database::getTimeEntriesPage(TimeEntryCursor& cursor, int pageSize, const RowVisitor<TimeEntry>& visitor) {
+    const char* firstPageSQL = "SELECT id, employee_id, date_worked, hours_worked FROM time_entries "
+        "ORDER BY date_worked ASC, id ASC LIMIT ?1;";
+
+    const char* nextPageSQL = "SELECT id, employee_id, date_worked, hours_worked FROM time_entries "
+        "WHERE (date_worked, id) > (?2, ?3) "
+        "ORDER BY date_worked ASC, id ASC LIMIT ?1;";
 
-    const char* SQL = "SELECT employee_id, date_worked, hours_worked FROM time_entries ORDER BY date_worked ASC;";
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, cursor.atStart ? firstPageSQL : nextPageSQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return stored_time_entries;
+        return -1;
+    }
+
+    sqlite3_bind_int(stmt, 1, pageSize);
+    if (!cursor.atStart) {
+        sqlite3_bind_int(stmt, 2, cursor.dateWorked.days);
+        sqlite3_bind_int(stmt, 3, cursor.id);
     }
 
+    TimeEntry timeEntryRecord;
+    int rowCount{ 0 };
+
     while (sqlite3_step(stmt) == SQLITE_ROW) {
-        TimeEntry timeEntryRecord;
+        timeEntryRecord.employeeID = sqlite3_column_int(stmt, 1);
+        timeEntryRecord.dateWorked.days = sqlite3_column_int(stmt, 2);
+        timeEntryRecord.hoursWorked = sqlite3_column_double(stmt, 3);
 
-        timeEntryRecord.employeeID = sqlite3_column_int(stmt, 0);
-        timeEntryRecord.dateWorked = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-        timeEntryRecord.hoursWorked = sqlite3_column_double(stmt, 2);
+        cursor.atStart = false;
+        cursor.id = sqlite3_column_int(stmt, 0);
+        cursor.dateWorked = timeEntryRecord.dateWorked;
+        rowCount++;
 
-        stored_time_entries.push_back(timeEntryRecord);
+        if (!visitor(timeEntryRecord))
+            break;
     }
 
     sqlite3_finalize(stmt);
-    return stored_time_entries;
+    return rowCount;
 }
 
-std::vector<Employee> Database::getEmployees() {
-    std::vector<Employee> stored_employees;
+int Database::getEmployeesPage(EmployeeCursor& cursor, int pageSize, const RowVisitor<Employee>& visitor) {
+    const char* firstPageSQL = "SELECT id, first_name, last_name, department_id, employment_type_id, hire_date, hourly_rate, is_active "
+        "FROM employees ORDER BY last_name DESC, first_name DESC, id DESC LIMIT ?1;";
+
+    const char* nextPageSQL = "SELECT id, first_name, last_name, department_id, employment_type_id, hire_date, hourly_rate, is_active "
+        "FROM employees WHERE (last_name, first_name, id) < (?2, ?3, ?4) "
+        "ORDER BY last_name DESC, first_name DESC, id DESC LIMIT ?1;";
 
-    const char* SQL = "SELECT id, first_name, last_name, department, employment_type, hire_date, hourly_rate, is_active "
-        "FROM employees ORDER BY last_name DESC, first_name DESC;";
-    
     sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+    if (sqlite3_prepare_v2(db, cursor.atStart ? firstPageSQL : nextPageSQL, -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
-        return stored_employees;
+        return -1;
     }
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        Employee emp;
+    sqlite3_bind_int(stmt, 1, pageSize);
+    if (!cursor.atStart) {
+        sqlite3_bind_text(stmt, 2, cursor.lastName.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, cursor.firstName.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 4, cursor.id);
+    }
+
+    Employee emp;
+    int rowCount{ 0 };
 
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
         emp.id = sqlite3_column_int(stmt, 0);
         emp.firstName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
         emp.lastName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-        emp.department = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-        emp.employmentType = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-        emp.hireDate = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 5));
+        emp.departmentID = sqlite3_column_int(stmt, 3);
+        emp.employmentTypeID = sqlite3_column_int(stmt, 4);
+        emp.hireDate.days = sqlite3_column_int(stmt, 5);
         emp.hourlyRate = sqlite3_column_double(stmt, 6);
         emp.isActive = sqlite3_column_int(stmt, 7);
 
-        stored_employees.push_back(emp);
+        rowCount++;
+        if (!visitor(emp))
+            break;
+    }
+
+    // Bound text above points into the cursor, so it is only updated once the statement is done //
+    if (rowCount > 0) {
+        cursor.atStart = false;
+        cursor.lastName = emp.lastName;
+        cursor.firstName = emp.firstName;
+        cursor.id = emp.id;
+    }
+
+    sqlite3_finalize(stmt);
+    return rowCount;
+}
+
+// Streams the time entries of a date range in date order, read entirely from idx_time_entries_pay. //
+// Every payroll computation (real runs, reprocessing, simulations) gets its hours from here         //
+bool Database::scanPayrollEntries(const Date& startDate, const Date& endDate, const RowVisitor<TimeEntry>& visitor) {
+    if (sqlite3_get_autocommit(db) && !attachArchives(startDate, endDate))
+        return false;
+
+    // Archived years in the range are read from their attached files alongside the main table //
+    std::string SQL = "SELECT employee_id, date_worked, hours_worked, COALESCE(shift_start, -1) FROM main.time_entries "
+        "WHERE date_worked BETWEEN ?1 AND ?2";
+
+    for (int year = startDate.year(); year <= endDate.year(); year++) {
+        if (timeEntryArchives.count(year) == 0)
+            continue;
+
+        if (attachedArchives.count(year) == 0) {
+            std::cerr << "\nTime entries of " << year << " are archived and could not be attached\n";
+            return false;
+        }
+
+        SQL += " UNION ALL SELECT employee_id, date_worked, hours_worked, COALESCE(shift_start, -1) FROM archive_"
+            + std::to_string(year) + ".time_entries WHERE date_worked BETWEEN ?1 AND ?2";
+    }
+
+    SQL += " ORDER BY date_worked ASC;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, startDate.days);
+    sqlite3_bind_int(stmt, 2, endDate.days);
+
+    // Anything but SQLITE_DONE (busy, I/O error, a broken archive) means the hours are incomplete //
+    TimeEntry entry;
+    int result;
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        entry.employeeID = sqlite3_column_int(stmt, 0);
+        entry.dateWorked.days = sqlite3_column_int(stmt, 1);
+        entry.hoursWorked = sqlite3_column_double(stmt, 2);
+        entry.shiftStart = sqlite3_column_int(stmt, 3);
+
+        if (!visitor(entry)) {
+            result = SQLITE_DONE;
+            break;
+        }
+    }
+
+    if (result != SQLITE_DONE)
+        std::cerr << "\nFailed to read time entries: " << sqlite3_errmsg(db) << '\n';
+
+    sqlite3_finalize(stmt);
+    return result == SQLITE_DONE;
+}
+
+const char* Database::payrollYtdUpsertSQL =
+    "INSERT INTO payroll_ytd (employee_id, year, gross_pay, net_pay, tax, hours_worked) VALUES (?, ?, ?, ?, ?, ?) "
+    "ON CONFLICT(employee_id, year) DO UPDATE SET "
+    "gross_pay = gross_pay + excluded.gross_pay, "
+    "net_pay = net_pay + excluded.net_pay, "
+    "tax = tax + excluded.tax, "
+    "hours_worked = hours_worked + excluded.hours_worked;";
+
+// Adds amounts (negative for corrections) to an employee's totals using a statement prepared from payrollYtdUpsertSQL //
+bool Database::addToPayrollYtd(sqlite3_stmt* ytdStmt, const int& employeeID, const int& year, const PayResult& amounts) {
+    sqlite3_bind_int(ytdStmt, 1, employeeID);
+    sqlite3_bind_int(ytdStmt, 2, year);
+    sqlite3_bind_double(ytdStmt, 3, amounts.grossPay);
+    sqlite3_bind_double(ytdStmt, 4, amounts.netPay);
+    sqlite3_bind_double(ytdStmt, 5, amounts.tax);
+    sqlite3_bind_double(ytdStmt, 6, amounts.hoursWorked);
+
+    int result = sqlite3_step(ytdStmt);
+    sqlite3_reset(ytdStmt);
+
+    if (result != SQLITE_DONE) {
+        std::cerr << "\nFailed to update year-to-date totals: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    return true;
+}
+
+bool Database::rebuildPayrollYtd() {
+    const char* SQL = "DELETE FROM payroll_ytd; "
+        "INSERT INTO payroll_ytd (employee_id, year, gross_pay, net_pay, tax, hours_worked) "
+        "SELECT pr.employee_id, CAST(strftime('%Y', p.end_date * 86400, 'unixepoch') AS INTEGER) AS pay_year, "
+        "SUM(pr.gross_pay), SUM(pr.net_pay), SUM(pr.tax), SUM(pr.hours_worked) "
+        "FROM payroll pr JOIN pay_periods p ON pr.pay_period_id = p.id "
+        "GROUP BY pr.employee_id, pay_year;";
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to rebuild year-to-date totals: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    if (sqlite3_exec(db, SQL, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to rebuild year-to-date totals: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+bool Database::getPayrollYtd(const int& employeeID, const int& year, PayrollYtd& ytd) {
+    const char* SQL = "SELECT gross_pay, net_pay, tax, hours_worked FROM payroll_ytd WHERE employee_id = ? AND year = ?;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    sqlite3_bind_int(stmt, 1, employeeID);
+    sqlite3_bind_int(stmt, 2, year);
+
+    ytd.employeeID = employeeID;
+    ytd.year = year;
+
+    bool found = sqlite3_step(stmt) == SQLITE_ROW;
+    if (found) {
+        ytd.grossPay = sqlite3_column_double(stmt, 0);
+        ytd.netPay = sqlite3_column_double(stmt, 1);
+        ytd.tax = sqlite3_column_double(stmt, 2);
+        ytd.hoursWorked = sqlite3_column_double(stmt, 3);
+    }
+
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+bool Database::rebuildDepartmentTotals() {
+    const char* SQL = "DELETE FROM payroll_department_totals; "
+        "INSERT INTO payroll_department_totals "
+        "(pay_period_id, department_id, employee_count, hours_worked, gross_pay, tax, net_pay) "
+        "SELECT pr.pay_period_id, COALESCE(e.department_id, 0) AS department, COUNT(*), "
+        "SUM(pr.hours_worked), SUM(pr.gross_pay), SUM(pr.tax), SUM(pr.net_pay) "
+        "FROM payroll pr JOIN employees e ON e.id = pr.employee_id "
+        "GROUP BY pr.pay_period_id, department;";
+
+    if (sqlite3_exec(db, "BEGIN IMMEDIATE;", nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to rebuild department totals: " << sqlite3_errmsg(db) << '\n';
+        return false;
+    }
+
+    if (sqlite3_exec(db, SQL, nullptr, nullptr, nullptr) != SQLITE_OK) {
+        std::cerr << "\nFailed to rebuild department totals: " << sqlite3_errmsg(db) << '\n';
+        sqlite3_exec(db, "ROLLBACK;", nullptr, nullptr, nullptr);
+        return false;
+    }
+
+    return sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK;
+}
+
+// Streams the cube cells of every pay period ending in year, ordered by period then department //
+int Database::getDepartmentTotals(const int& year, const RowVisitor<DepartmentTotals>& visitor) {
+    const char* SQL = "SELECT p.id, p.start_date, p.end_date, d.department_id, d.employee_count, "
+        "d.hours_worked, d.gross_pay, d.tax, d.net_pay "
+        "FROM pay_periods p JOIN payroll_department_totals d ON d.pay_period_id = p.id "
+        "WHERE p.end_date BETWEEN ? AND ? "
+        "ORDER BY p.start_date ASC, p.id ASC, d.department_id ASC;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return -1;
+    }
+
+    sqlite3_bind_int(stmt, 1, Date::fromCivil(year, 1, 1).days);
+    sqlite3_bind_int(stmt, 2, Date::fromCivil(year, 12, 31).days);
+
+    DepartmentTotals totals;
+    int rowCount{ 0 };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        totals.payPeriodID = sqlite3_column_int(stmt, 0);
+        totals.startDate.days = sqlite3_column_int(stmt, 1);
+        totals.endDate.days = sqlite3_column_int(stmt, 2);
+        totals.departmentID = sqlite3_column_int(stmt, 3);
+        totals.employeeCount = sqlite3_column_int(stmt, 4);
+        totals.hoursWorked = sqlite3_column_double(stmt, 5);
+        totals.grossPay = sqlite3_column_double(stmt, 6);
+        totals.tax = sqlite3_column_double(stmt, 7);
+        totals.netPay = sqlite3_column_double(stmt, 8);
+
+        rowCount++;
+        if (!visitor(totals))
+            break;
+    }
+
+    sqlite3_finalize(stmt);
+    return rowCount;
+}
+
+// Streams every payroll row of the period in employee order, joined with the employee and the year-to-date //
+// totals as of the period's end: payroll_ytd minus any later period of the same year already processed     //
+int Database::getPayStubs(const int& payPeriodID, const RowVisitor<PayStub>& visitor) {
+    const char* periodSQL = "SELECT start_date, end_date FROM pay_periods WHERE id = ?;";
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, periodSQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return -1;
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        std::cerr << "\nPay period " << payPeriodID << " not found\n";
+        sqlite3_finalize(stmt);
+        return -1;
+    }
+
+    Date startDate{ sqlite3_column_int(stmt, 0) };
+    Date endDate{ sqlite3_column_int(stmt, 1) };
+    sqlite3_finalize(stmt);
+
+    const int year = endDate.year();
+
+    const char* SQL = "SELECT pr.employee_id, e.first_name, e.last_name, e.department_id, e.hourly_rate, "
+        "pr.hours_worked, pr.gross_pay, pr.tax, pr.net_pay, "
+        "COALESCE(y.hours_worked, 0) - COALESCE(l.hours_worked, 0), "
+        "COALESCE(y.gross_pay, 0) - COALESCE(l.gross_pay, 0), "
+        "COALESCE(y.tax, 0) - COALESCE(l.tax, 0), "
+        "COALESCE(y.net_pay, 0) - COALESCE(l.net_pay, 0) "
+        "FROM payroll pr "
+        "JOIN employees e ON e.id = pr.employee_id "
+        "LEFT JOIN payroll_ytd y ON y.employee_id = pr.employee_id AND y.year = ?2 "
+        "LEFT JOIN (SELECT lp.employee_id, SUM(lp.hours_worked) AS hours_worked, SUM(lp.gross_pay) AS gross_pay, "
+        "SUM(lp.tax) AS tax, SUM(lp.net_pay) AS net_pay FROM payroll lp "
+        "JOIN pay_periods p ON p.id = lp.pay_period_id "
+        "WHERE p.end_date > ?3 AND p.end_date <= ?4 GROUP BY lp.employee_id) l ON l.employee_id = pr.employee_id "
+        "WHERE pr.pay_period_id = ?1 "
+        "ORDER BY pr.employee_id ASC;";
+
+    if (sqlite3_prepare_v2(db, SQL, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "\nError sqlite3_prepare_v2: " << sqlite3_errmsg(db) << '\n';
+        return -1;
+    }
+
+    sqlite3_bind_int(stmt, 1, payPeriodID);
+    sqlite3_bind_int(stmt, 2, year);
+    sqlite3_bind_int(stmt, 3, endDate.days);
+    sqlite3_bind_int(stmt, 4, Date::fromCivil(year, 12, 31).days);
+
+    PayStub stub;
+    stub.payPeriodID = payPeriodID;
+    stub.startDate = startDate;
+    stub.endDate = endDate;
+    stub.ytd.year = year;
+
+    int rowCount{ 0 };
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        stub.employeeID = sqlite3_column_int(stmt, 0);
+        stub.firstName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        stub.lastName = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        stub.departmentID = sqlite3_column_int(stmt, 3);
+        stub.hourlyRate = sqlite3_column_double(stmt, 4);
+        stub.hoursWorked = sqlite3_column_double(stmt, 5);
+        stub.grossPay = sqlite3_column_double(stmt, 6);
+        stub.tax = sqlite3_column_double(stmt, 7);
+        stub.netPay = sqlite3_column_double(stmt, 8);
+        stub.ytd.employeeID = stub.employeeID;
+        stub.ytd.hoursWorked = sqlite3_column_double(stmt, 9);
+        stub.ytd.grossPay = sqlite3_column_double(stmt, 10);
+        stub.ytd.tax = sqlite3_column_double(stmt, 11);
+        stub.ytd.netPay = sqlite3_column_double(stmt, 12);
+
+        rowCount++;
+        if (!visitor(stub))
+            break;
     }
 
     sqlite3_finalize(stmt);
-    return stored_employees;
+    return rowCount;
 }
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <set>
 #include <thread>
 #include <chrono>
 
@@ -10,30 +12,100 @@
 #include "../models/PayPeriod.h"
 #include "../models/Payroll.h"
 #include "../models/EmployeePayroll.h"
+#include "../models/PayrollYtd.h"
+#include "../models/PayResult.h"
+#include "../models/DepartmentTotals.h"
+#include "../models/PayrollOverrides.h"
+#include "../models/PayrollSimulation.h"
+#include "../models/PayStub.h"
+#include "../models/PayPeriodIndex.h"
+#include "../models/EmployeeNameIndex.h"
+#include "../models/TimeEntryCoverage.h"
+#include "../models/Deduction.h"
+#include "../models/TimeEntryArchive.h"
 #include "../models/Employee.h"
 #include "../models/TimeEntry.h"
+#include "../models/ImportSummary.h"
+#include "../models/Cursor.h"
+#include "../models/Dictionary.h"
+#include "../tax/TaxEngine.h"
+#include "../payroll/PayRules.h"
+#include "../payroll/DeductionTable.h"
 
 class Database
 {
 private:
 	sqlite3* db;
+	std::string databaseFile;
+	int consoleWaitTimer;
+	size_t payrollChunkSize;
+	Dictionary departments;
+	Dictionary employmentTypes;
+	PayPeriodIndex payPeriodIndex;
+	EmployeeNameIndex employeeNameIndex;
+	std::map<int, TimeEntryArchive> timeEntryArchives;
+	std::set<int> attachedArchives;
+
+	static const char* payrollYtdUpsertSQL;
+	bool addToPayrollYtd(sqlite3_stmt* ytdStmt, const int& employeeID, const int& year, const PayResult& amounts);
+	bool clearTimeEntryChanges(const Date& startDate, const Date& endDate);
+	bool scanPayrollEntries(const Date& startDate, const Date& endDate, const RowVisitor<TimeEntry>& visitor);
+	bool refreshDepartmentTotals(const int& payPeriodID);
+	bool getPayrollRunCheckpoint(const int& payPeriodID, int& lastEmployeeID, int& employeesDone);
+	bool loadPayPeriodIndex();
+	bool loadEmployeeNameIndex();
+	bool loadTimeEntryArchives();
+	std::string archiveFileName(int year) const;
+	bool isArchived(const Date& dateWorked) const;
+	bool attachArchive(int year, const std::string& fileName);
+	bool attachArchives(const Date& startDate, const Date& endDate);
+	bool loadDeductions(const int& payPeriodID, const std::vector<int>& employeeIDs, DeductionTable& table);
+	bool recordDeductions(const int& payPeriodID, const std::vector<AppliedDeduction>& rows);
+	bool loadDictionary(const std::string& tableName, Dictionary& dictionary);
+	bool internName(const std::string& tableName, Dictionary& dictionary, const std::string& name, int& id);
 public:
 	Database();
 	~Database();
 
 	bool openDatabase(const std::string& fileName);
 	bool SetupTables();
+	void setConsoleWaitTimer(int milliseconds);
+	void setPayrollChunkSize(int employees);
 	
-	bool addPayPeriod(const std::string& startDate, const std::string& endDate);
+	bool addPayPeriod(const Date& startDate, const Date& endDate);
 	bool removePayPeriod(const int& payPeriodID);
-	bool insertPayrollForPayPeriod(const int& payPeriodID);
+	const PayPeriodIndex& getPayPeriodIndex() const;
+	int auditTimeEntryCoverage(const RowVisitor<TimeEntryCoverage>& visitor);
+	bool insertPayrollForPayPeriod(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules);
+	bool reprocessPayPeriod(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules, int& employeesUpdated);
+	bool simulatePayroll(const int& payPeriodID, const TaxEngine& taxEngine, const PayRules& payRules, const PayrollOverrides& overrides, std::vector<PayrollSimulation>& results);
+	bool processOpenPayPeriods(const TaxEngine& taxEngine, const PayRules& payRules, int& periodsProcessed, int& recordsWritten);
 	bool addTimeEntry(const TimeEntry& timeEntry);
+	bool archiveTimeEntries(const int& year, int& entriesMoved);
+	std::vector<TimeEntryArchive> getTimeEntryArchives() const;
+	bool importTimeEntries(const std::string& fileName, bool upsert, const std::string& rejectFileName, ImportSummary& summary);
 	bool setEmployeeStatus(const int& employeeID, const bool& isActive);
 	bool addEmployee(const Employee& emp);
+	int searchEmployees(const std::string& query, int limit, const RowVisitor<Employee>& visitor);
+	bool addDeduction(const Deduction& deduction);
+	bool setDeductionStatus(const int& deductionID, const bool& isActive);
+	std::vector<Deduction> getEmployeeDeductions(const int& employeeID);
+	bool internDepartment(const std::string& name, int& departmentID);
+	bool internEmploymentType(const std::string& name, int& employmentTypeID);
+	const Dictionary& getDepartments() const;
+	const Dictionary& getEmploymentTypes() const;
+	bool rebuildPayrollYtd();
+	bool getPayrollYtd(const int& employeeID, const int& year, PayrollYtd& ytd);
+	bool rebuildDepartmentTotals();
+	int getDepartmentTotals(const int& year, const RowVisitor<DepartmentTotals>& visitor);
+	int getPayStubs(const int& payPeriodID, const RowVisitor<PayStub>& visitor);
 
 	std::vector<PayPeriod> getPayPeriods();
-	std::vector<Payroll> getPayrollRecords();
-	std::vector<EmployeePayroll> getEmployeePayrollHistory(const int& employeeID);
-	std::vector<TimeEntry> getTimeEntries();
-	std::vector<Employee> getEmployees();
+
+	// Keyset-paginated listings: each call streams up to pageSize rows after cursor into visitor, //
+	// advances cursor to the last row read and returns the row count (-1 on error)               //
+	int getPayrollRecordsPage(PayrollCursor& cursor, int pageSize, const RowVisitor<Payroll>& visitor);
+	int getEmployeePayrollHistoryPage(const int& employeeID, EmployeePayrollCursor& cursor, int pageSize, const RowVisitor<EmployeePayroll>& visitor);
+	int getTimeEntriesPage(TimeEntryCursor& cursor, int pageSize, const RowVisitor<TimeEntry>& visitor);
+	int getEmployeesPage(EmployeeCursor& cursor, int pageSize, const RowVisitor<Employee>& visitor);
 };
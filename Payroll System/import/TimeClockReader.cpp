@@ -0,0 +1,123 @@
+#include <charconv>
+#include <cstring>
+#include "TimeClockReader.h"
+
+TimeClockReader::TimeClockReader(size_t bufferSize) : buffer(bufferSize) {}
+
+bool TimeClockReader::open(const std::string& fileName) {
+	file.open(fileName, std::ios::binary);
+	begin = end = 0;
+	lineNumber = 0;
+
+	return file.is_open();
+}
+
+// Moves the unread tail to the front of the buffer and appends the next chunk of the file //
+bool TimeClockReader::fillBuffer() {
+	if (!file)
+		return false;
+
+	size_t remaining = end - begin;
+	if (begin > 0 && remaining > 0)
+		std::memmove(buffer.data(), buffer.data() + begin, remaining);
+
+	begin = 0;
+	end = remaining;
+
+	if (end == buffer.size())
+		buffer.resize(buffer.size() * 2); // A single line is longer than the buffer
+
+	file.read(buffer.data() + end, static_cast<std::streamsize>(buffer.size() - end));
+	std::streamsize bytesRead = file.gcount();
+	end += static_cast<size_t>(bytesRead);
+
+	return bytesRead > 0;
+}
+
+bool TimeClockReader::parseLine(const char* line, size_t length, TimeEntry& entry) {
+	const char* position = line;
+	const char* lineEnd = line + length;
+
+	std::from_chars_result idResult = std::from_chars(position, lineEnd, entry.employeeID);
+	if (idResult.ec != std::errc() || idResult.ptr == lineEnd || *idResult.ptr != ',')
+		return false;
+
+	position = idResult.ptr + 1;
+	const char* dateEnd = static_cast<const char*>(std::memchr(position, ',', lineEnd - position));
+	if (dateEnd == nullptr || !Date::parse(position, dateEnd - position, entry.dateWorked))
+		return false;
+
+	position = dateEnd + 1;
+	std::from_chars_result hoursResult = std::from_chars(position, lineEnd, entry.hoursWorked);
+	if (hoursResult.ec != std::errc() || (hoursResult.ptr != lineEnd && *hoursResult.ptr != ','))
+		return false;
+
+	if (entry.hoursWorked < 0.0 || entry.hoursWorked > 24.0)
+		return false;
+
+	// Optional shift start as HH:MM //
+	entry.shiftStart = -1;
+	if (hoursResult.ptr == lineEnd)
+		return true;
+
+	int hour, minute;
+	position = hoursResult.ptr + 1;
+	std::from_chars_result hourResult = std::from_chars(position, lineEnd, hour);
+	if (hourResult.ec != std::errc() || hourResult.ptr == lineEnd || *hourResult.ptr != ':')
+		return false;
+
+	std::from_chars_result minuteResult = std::from_chars(hourResult.ptr + 1, lineEnd, minute);
+	if (minuteResult.ec != std::errc() || minuteResult.ptr != lineEnd || hour > 23 || minute > 59 || hour < 0 || minute < 0)
+		return false;
+
+	entry.shiftStart = hour * 60 + minute;
+	return true;
+}
+
+// Returns the next line parsed into entry. line / length point at the raw text of that line
+// (valid until the following call) so callers can copy rejected lines out unchanged.
+TimeClockReader::Status TimeClockReader::next(TimeEntry& entry, const char*& line, size_t& length) {
+	while (true) {
+		const char* start = buffer.data() + begin;
+		const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+
+		if (newline == nullptr) {
+			if (fillBuffer())
+				continue;
+
+			if (begin == end)
+				return Status::End;
+
+			// Last line without a trailing newline //
+			line = start;
+			length = end - begin;
+			begin = end;
+		}
+		else {
+			line = start;
+			length = static_cast<size_t>(newline - start);
+			begin += length + 1;
+		}
+
+		lineNumber++;
+
+		if (length > 0 && line[length - 1] == '\r')
+			length--;
+
+		if (length == 0)
+			continue;
+
+		if (parseLine(line, length, entry))
+			return Status::Record;
+
+		// A first line that does not start with an employee id is a column header //
+		if (lineNumber == 1 && (line[0] < '0' || line[0] > '9'))
+			continue;
+
+		return Status::Invalid;
+	}
+}
+
+int TimeClockReader::getLineNumber() const {
+	return lineNumber;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../models/TimeEntry.h"
+
+// Streams time-clock CSV exports (employee_id,date_worked,hours_worked[,shift_start HH:MM]) through a fixed-size buffer.
+// Fields are parsed in place, so no allocation happens per line or per field.
+class TimeClockReader
+{
+private:
+	std::ifstream file;
+	std::vector<char> buffer;
+	size_t begin{ 0 };
+	size_t end{ 0 };
+	int lineNumber{ 0 };
+
+	bool fillBuffer();
+	static bool parseLine(const char* line, size_t length, TimeEntry& entry);
+public:
+	enum class Status { Record, Invalid, End };
+
+	explicit TimeClockReader(size_t bufferSize = 1 << 20);
+
+	bool open(const std::string& fileName);
+	Status next(TimeEntry& entry, const char*& line, size_t& length);
+	int getLineNumber() const;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "Date.h"
+
+// Called once per streamed row, return false to stop reading early //
+template <typename Row>
+using RowVisitor = std::function<bool(const Row&)>;
+
+// Keyset pagination positions: every page continues after the last row of the previous one, //
+// so a listing never re-reads skipped rows the way OFFSET would                             //
+
+struct TimeEntryCursor {
+	bool atStart{ true };
+	Date dateWorked;
+	int id{ 0 };
+};
+
+struct PayrollCursor {
+	bool atStart{ true };
+	int payPeriodID{ 0 };
+	int employeeID{ 0 };
+};
+
+struct EmployeePayrollCursor {
+	bool atStart{ true };
+	Date startDate;
+	int payPeriodID{ 0 };
+};
+
+struct EmployeeCursor {
+	bool atStart{ true };
+	std::string lastName;
+	std::string firstName;
+	int id{ 0 };
+};
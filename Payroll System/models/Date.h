@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+// Calendar date stored as days since 1970-01-01, matching the INTEGER date columns in the database //
+struct Date {
+	int32_t days{ 0 };
+
+	static bool isLeapYear(int year) {
+		return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	}
+
+	static int daysInMonth(int year, int month) {
+		static const int monthDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		return (month == 2 && isLeapYear(year)) ? 29 : monthDays[month - 1];
+	}
+
+	static Date fromCivil(int year, int month, int day) {
+		year -= month <= 2;
+		const int era = (year >= 0 ? year : year - 399) / 400;
+		const int yearOfEra = year - era * 400;
+		const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+		const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+
+		return Date{ era * 146097 + dayOfEra - 719468 };
+	}
+
+	void toCivil(int& year, int& month, int& day) const {
+		const int z = days + 719468;
+		const int era = (z >= 0 ? z : z - 146096) / 146097;
+		const int dayOfEra = z - era * 146097;
+		const int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+		const int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+		const int monthIndex = (5 * dayOfYear + 2) / 153;
+
+		day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+		month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+		year = yearOfEra + era * 400 + (month <= 2);
+	}
+
+	static Date today() {
+		return Date{ static_cast<int32_t>(std::time(nullptr) / 86400) };
+	}
+
+	// 0 = Sunday ... 6 = Saturday (1970-01-01 was a Thursday) //
+	int weekday() const {
+		int weekday = (days + 4) % 7;
+		return weekday < 0 ? weekday + 7 : weekday;
+	}
+
+	int year() const {
+		int y, m, d;
+		toCivil(y, m, d);
+		return y;
+	}
+
+	// Accepts day-month-year (31-01-2026) as typed by users and year-month-day (2026-01-31) as exported //
+	static bool parse(const char* text, size_t length, Date& out) {
+		if (length != 10)
+			return false;
+
+		auto digits = [text](int from, int count, int& value) {
+			value = 0;
+			for (int i = from; i < from + count; i++) {
+				if (text[i] < '0' || text[i] > '9')
+					return false;
+
+				value = value * 10 + (text[i] - '0');
+			}
+			return true;
+		};
+
+		int year, month, day;
+		if (text[2] == '-' && text[5] == '-') {
+			if (!digits(0, 2, day) || !digits(3, 2, month) || !digits(6, 4, year))
+				return false;
+		}
+		else if (text[4] == '-' && text[7] == '-') {
+			if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day))
+				return false;
+		}
+		else {
+			return false;
+		}
+
+		if (year < 1 || month < 1 || month > 12 || day < 1 || day > daysInMonth(year, month))
+			return false;
+
+		out = fromCivil(year, month, day);
+		return true;
+	}
+
+	static bool parse(const std::string& text, Date& out) {
+		return parse(text.c_str(), text.size(), out);
+	}
+
+	// Writes year-month-day and a null terminator, buffer must hold 11 characters //
+	void format(char* buffer) const {
+		int y, m, d;
+		toCivil(y, m, d);
+
+		buffer[0] = static_cast<char>('0' + y / 1000 % 10);
+		buffer[1] = static_cast<char>('0' + y / 100 % 10);
+		buffer[2] = static_cast<char>('0' + y / 10 % 10);
+		buffer[3] = static_cast<char>('0' + y % 10);
+		buffer[4] = '-';
+		buffer[5] = static_cast<char>('0' + m / 10);
+		buffer[6] = static_cast<char>('0' + m % 10);
+		buffer[7] = '-';
+		buffer[8] = static_cast<char>('0' + d / 10);
+		buffer[9] = static_cast<char>('0' + d % 10);
+		buffer[10] = '\0';
+	}
+
+	std::string toString() const {
+		char buffer[11];
+		format(buffer);
+		return std::string(buffer, 10);
+	}
+
+	bool operator==(const Date& other) const { return days == other.days; }
+	bool operator!=(const Date& other) const { return days != other.days; }
+	bool operator<(const Date& other) const { return days < other.days; }
+	bool operator<=(const Date& other) const { return days <= other.days; }
+	bool operator>(const Date& other) const { return days > other.days; }
+	bool operator>=(const Date& other) const { return days >= other.days; }
+};
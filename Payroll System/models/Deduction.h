@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+
+// A standing deduction taken from an employee's pay every period. percent is of gross pay and amount //
+// is a flat sum per period, both may be set. Caps of 0 mean no cap, totalCap limits the sum over all  //
+// periods (eg. the balance of a garnishment order) and deductedTotal is what has been taken so far     //
+struct Deduction {
+	int id{ 0 };
+	int employeeID;
+
+	std::string kind; // pension, health, garnishment or other
+	std::string name;
+	bool preTax{ false };
+
+	double percent{ 0.0 };
+	double amount{ 0.0 };
+	double periodCap{ 0.0 };
+	double totalCap{ 0.0 };
+	double deductedTotal{ 0.0 };
+
+	bool isActive{ true };
+};
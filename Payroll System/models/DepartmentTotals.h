@@ -0,0 +1,17 @@
+#pragma once
+
+#include "Date.h"
+
+// One cell of the department x pay period labor cost cube //
+struct DepartmentTotals {
+	int payPeriodID;
+	Date startDate;
+	Date endDate;
+	int departmentID{ 0 }; // 0 = no department
+
+	int employeeCount{ 0 };
+	double hoursWorked{ 0.0 };
+	double grossPay{ 0.0 };
+	double tax{ 0.0 };
+	double netPay{ 0.0 };
+};
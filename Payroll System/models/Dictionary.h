@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// In-memory copy of a lookup table (id, name): rows carry the 4-byte id and the name is stored once here. //
+// Ids are the table's INTEGER PRIMARY KEY, 0 means "not set"                                              //
+class Dictionary
+{
+private:
+	std::vector<std::string> names{ std::string() };
+	std::unordered_map<std::string, int> ids;
+public:
+	void add(int id, const std::string& name) {
+		if (id <= 0)
+			return;
+
+		if (static_cast<size_t>(id) >= names.size())
+			names.resize(static_cast<size_t>(id) + 1);
+
+		names[id] = name;
+		ids[name] = id;
+	}
+
+	int find(const std::string& name) const {
+		auto it = ids.find(name);
+		return it == ids.end() ? 0 : it->second;
+	}
+
+	const std::string& name(int id) const {
+		return (id > 0 && static_cast<size_t>(id) < names.size()) ? names[id] : names[0];
+	}
+
+	void clear() {
+		names.assign(1, std::string());
+		ids.clear();
+	}
+
+	size_t size() const {
+		return ids.size();
+	}
+};
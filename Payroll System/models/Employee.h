@@ -1,15 +1,20 @@
 #pragma once
 
 #include <string>
+#include "Date.h"
 
 struct Employee {
     int id;
+    Date hireDate;
+
+    // Ids into the departments / employment_types lookup tables, names come from Database::getDepartments() //
+    int departmentID{ 0 };
+    int employmentTypeID{ 0 };
 
     std::string firstName;
     std::string lastName;
-    std::string department;
-    std::string employmentType;
-    std::string hireDate;
+    std::string jurisdiction{ "DEFAULT" };
+    std::string filingStatus{ "single" };
 
     double hourlyRate;
     bool isActive{ false };
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+// In-memory prefix index over employee first names, last names and department names. Every word is   //
+// stored lowercased next to its employee id in a sorted array, so all words starting with a typed      //
+// prefix are two binary searches away, however many employees there are. New words go to a small      //
+// sorted side array first, which is merged into the main one once it fills up                          //
+class EmployeeNameIndex
+{
+private:
+	static constexpr size_t mergeThreshold{ 1024 };
+
+	struct Term {
+		std::string word;
+		int employeeID;
+		bool department;
+
+		bool operator<(const Term& other) const {
+			return word != other.word ? word < other.word : employeeID < other.employeeID;
+		}
+	};
+
+	using Run = std::pair<std::vector<Term>::const_iterator, std::vector<Term>::const_iterator>;
+
+	std::vector<Term> terms;
+	std::vector<Term> recent;
+
+	void addWords(const std::string& text, int employeeID, bool department) {
+		for (std::string& word : tokenize(text)) {
+			Term term{ std::move(word), employeeID, department };
+			auto position = std::upper_bound(recent.begin(), recent.end(), term);
+			recent.insert(position, std::move(term));
+		}
+	}
+
+	void merge() {
+		size_t middle = terms.size();
+		terms.insert(terms.end(), std::make_move_iterator(recent.begin()), std::make_move_iterator(recent.end()));
+		std::inplace_merge(terms.begin(), terms.begin() + middle, terms.end());
+		recent.clear();
+	}
+
+	// Words are lowercase letters and digits, so bumping the last character bounds the prefix run //
+	static Run prefixRun(const std::vector<Term>& sorted, const std::string& prefix) {
+		std::string pastPrefix = prefix;
+		pastPrefix.back()++;
+
+		auto first = std::lower_bound(sorted.begin(), sorted.end(), Term{ prefix, 0, false });
+		return { first, std::lower_bound(first, sorted.end(), Term{ pastPrefix, 0, false }) };
+	}
+public:
+	// Lowercased runs of letters and digits: "O'Neil-Smith" gives "o", "neil" and "smith" //
+	static std::vector<std::string> tokenize(const std::string& text) {
+		std::vector<std::string> words;
+		std::string word;
+
+		for (char c : text) {
+			if (std::isalnum(static_cast<unsigned char>(c))) {
+				word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			}
+			else if (!word.empty()) {
+				words.push_back(word);
+				word.clear();
+			}
+		}
+
+		if (!word.empty())
+			words.push_back(word);
+
+		return words;
+	}
+
+	void clear() {
+		terms.clear();
+		recent.clear();
+	}
+
+	void add(int employeeID, const std::string& firstName, const std::string& lastName, const std::string& department) {
+		addWords(firstName, employeeID, false);
+		addWords(lastName, employeeID, false);
+		addWords(department, employeeID, true);
+
+		if (recent.size() >= mergeThreshold)
+			merge();
+	}
+
+	// Ids of the employees matching every word of query as a prefix, best first, at most limit of them. //
+	// A whole word scores higher than a prefix and a name higher than a department, ties go to lower ids //
+	void search(const std::string& query, size_t limit, std::vector<int>& employeeIDs) const {
+		employeeIDs.clear();
+
+		std::vector<std::string> words = tokenize(query);
+		if (words.empty() || limit == 0)
+			return;
+
+		struct Match {
+			size_t wordLength;
+			Run runs[2];
+
+			size_t size() const {
+				return static_cast<size_t>((runs[0].second - runs[0].first) + (runs[1].second - runs[1].first));
+			}
+		};
+
+		std::vector<Match> matches;
+		for (const std::string& word : words) {
+			Match match{ word.size(), { prefixRun(terms, word), prefixRun(recent, word) } };
+			if (match.size() == 0)
+				return;
+
+			matches.push_back(match);
+		}
+
+		// The narrowest word picks the candidates, the others can only keep or drop them //
+		std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) { return a.size() < b.size(); });
+
+		std::unordered_map<int, int> scores;
+		for (size_t i = 0; i < matches.size(); i++) {
+			std::unordered_map<int, int> matched;
+			for (const Run& run : matches[i].runs) {
+				for (auto term = run.first; term != run.second; ++term) {
+					if (i > 0 && scores.find(term->employeeID) == scores.end())
+						continue;
+
+					int score = (term->word.size() == matches[i].wordLength ? 2 : 1) * (term->department ? 1 : 2);
+					int& best = matched[term->employeeID];
+					best = std::max(best, score);
+				}
+			}
+
+			if (i > 0) {
+				for (auto& match : matched)
+					match.second += scores[match.first];
+			}
+
+			scores = std::move(matched);
+			if (scores.empty())
+				return;
+		}
+
+		std::vector<std::pair<int, int>> ranked(scores.begin(), scores.end());
+		auto better = [](const std::pair<int, int>& a, const std::pair<int, int>& b) {
+			return a.second != b.second ? a.second > b.second : a.first < b.first;
+		};
+
+		size_t count = std::min(limit, ranked.size());
+		std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(), better);
+
+		for (size_t i = 0; i < count; i++)
+			employeeIDs.push_back(ranked[i].first);
+	}
+
+	size_t size() const {
+		return terms.size() + recent.size();
+	}
+};
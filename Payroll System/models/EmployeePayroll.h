@@ -1,12 +1,13 @@
 #pragma once
 
 #include <string>
+#include "Date.h"
 
 struct EmployeePayroll {
     int payPeriodID;
+    Date startDate;
+    Date endDate;
 
-    std::string startDate;
-    std::string endDate;
     std::string processedAt;
 
     double grossPay;
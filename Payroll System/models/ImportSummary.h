@@ -0,0 +1,7 @@
+#pragma once
+
+struct ImportSummary {
+	long long imported{ 0 };
+	long long rejected{ 0 };
+	long long batches{ 0 };
+};
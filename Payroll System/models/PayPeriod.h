@@ -1,11 +1,12 @@
 #pragma once
 
 #include <string>
+#include "Date.h"
 
 struct PayPeriod {
 	int id;
-	std::string startDate;
-	std::string endDate;
+	Date startDate;
+	Date endDate;
 	std::string processedAt;
 
 	bool isProcessed() const {
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "Date.h"
+
+// In-memory copy of the pay period date ranges sorted by start date, so overlap, gap and coverage  //
+// checks are a binary search instead of a table scan. maxEnd[i] is the latest end date among        //
+// periods[0..i], which keeps the lookups correct when overlapping periods already exist in the table //
+class PayPeriodIndex
+{
+public:
+	struct Period {
+		int id;
+		Date startDate;
+		Date endDate;
+	};
+private:
+	std::vector<Period> periods;
+	std::vector<Date> maxEnd;
+
+	void rebuildMaxEnd(size_t from) {
+		maxEnd.resize(periods.size());
+		for (size_t i = from; i < periods.size(); i++)
+			maxEnd[i] = (i > 0 && maxEnd[i - 1] > periods[i].endDate) ? maxEnd[i - 1] : periods[i].endDate;
+	}
+
+	// Index of the first period starting after date //
+	size_t startingAfter(const Date& date) const {
+		return static_cast<size_t>(std::upper_bound(periods.begin(), periods.end(), date,
+			[](const Date& value, const Period& period) { return value < period.startDate; }) - periods.begin());
+	}
+public:
+	void clear() {
+		periods.clear();
+		maxEnd.clear();
+	}
+
+	void add(int id, const Date& startDate, const Date& endDate) {
+		size_t position = startingAfter(startDate);
+		periods.insert(periods.begin() + position, { id, startDate, endDate });
+		rebuildMaxEnd(position);
+	}
+
+	void remove(int id) {
+		for (size_t i = 0; i < periods.size(); i++) {
+			if (periods[i].id == id) {
+				periods.erase(periods.begin() + i);
+				rebuildMaxEnd(i);
+				return;
+			}
+		}
+	}
+
+	// Id of a period sharing at least one day with startDate - endDate, 0 if none //
+	int findOverlap(const Date& startDate, const Date& endDate) const {
+		for (size_t i = startingAfter(endDate); i > 0 && maxEnd[i - 1] >= startDate; i--) {
+			if (periods[i - 1].endDate >= startDate)
+				return periods[i - 1].id;
+		}
+
+		return 0;
+	}
+
+	// Ids of every period containing date //
+	void covering(const Date& date, std::vector<int>& ids) const {
+		ids.clear();
+		for (size_t i = startingAfter(date); i > 0 && maxEnd[i - 1] >= date; i--) {
+			if (periods[i - 1].endDate >= date)
+				ids.push_back(periods[i - 1].id);
+		}
+	}
+
+	// Days left uncovered between the periods ending before startDate and a new period starting on it //
+	bool gapBefore(const Date& startDate, Date& gapStart, Date& gapEnd) const {
+		size_t before = static_cast<size_t>(std::lower_bound(periods.begin(), periods.end(), startDate,
+			[](const Period& period, const Date& value) { return period.startDate < value; }) - periods.begin());
+
+		if (before == 0 || maxEnd[before - 1].days + 1 >= startDate.days)
+			return false;
+
+		gapStart.days = maxEnd[before - 1].days + 1;
+		gapEnd.days = startDate.days - 1;
+		return true;
+	}
+
+	// Days left uncovered between a new period ending on endDate and the next period after it //
+	bool gapAfter(const Date& endDate, Date& gapStart, Date& gapEnd) const {
+		size_t after = startingAfter(endDate);
+
+		if (after == periods.size() || periods[after].startDate.days <= endDate.days + 1)
+			return false;
+
+		gapStart.days = endDate.days + 1;
+		gapEnd.days = periods[after].startDate.days - 1;
+		return true;
+	}
+
+	const Period* find(int id) const {
+		for (const Period& period : periods) {
+			if (period.id == id)
+				return &period;
+		}
+
+		return nullptr;
+	}
+
+	size_t size() const {
+		return periods.size();
+	}
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+struct PayResult {
+	double hoursWorked{ 0.0 };
+	double overtimeHours{ 0.0 };
+	double grossPay{ 0.0 };
+	double tax{ 0.0 };
+	double deductions{ 0.0 };
+	double netPay{ 0.0 };
+};
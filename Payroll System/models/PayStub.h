@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+#include "Date.h"
+#include "PayrollYtd.h"
+
+// One employee's payroll row for a pay period joined with the employee and year-to-date totals //
+struct PayStub {
+	int employeeID;
+	int payPeriodID;
+	Date startDate;
+	Date endDate;
+
+	std::string firstName;
+	std::string lastName;
+	int departmentID{ 0 };
+	double hourlyRate;
+
+	double hoursWorked;
+	double grossPay;
+	double tax;
+	double netPay;
+
+	PayrollYtd ytd;
+};
@@ -1,15 +1,16 @@
 #pragma once
 
 #include <string>
+#include "Date.h"
 
 struct Payroll {
 	int employeeID;
 	int payPeriodID;
+	Date startDate;
+	Date endDate;
 
 	std::string firstName;
 	std::string lastName;
-	std::string startDate;
-	std::string endDate;
 
 	double grossPay;
 	double netPay;
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <unordered_map>
+
+// Hypothetical changes applied by a payroll simulation, nothing is stored //
+struct PayrollOverrides {
+	double rateChangePercent{ 0.0 };             // Applied to every employee's hourly rate
+	std::unordered_map<int, double> hourlyRates; // employee id -> new hourly rate, replaces the percentage change
+};
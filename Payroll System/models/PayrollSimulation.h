@@ -0,0 +1,12 @@
+#pragma once
+
+#include "PayResult.h"
+
+// Simulated pay for one employee next to what the last real run of the period paid //
+struct PayrollSimulation {
+	int employeeID;
+	bool hasCurrent{ false }; // false when the period was not processed or the employee was not paid in it
+
+	PayResult current;
+	PayResult simulated;
+};
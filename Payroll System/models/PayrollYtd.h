@@ -0,0 +1,11 @@
+#pragma once
+
+struct PayrollYtd {
+	int employeeID;
+	int year;
+
+	double grossPay{ 0.0 };
+	double netPay{ 0.0 };
+	double tax{ 0.0 };
+	double hoursWorked{ 0.0 };
+};
@@ -1,9 +1,10 @@
 #pragma once
 
-#include <string>
+#include "Date.h"
 
 struct TimeEntry {
 	int employeeID;
-	std::string dateWorked;
+	Date dateWorked;
 	double hoursWorked;
+	int shiftStart{ -1 }; // Minutes after midnight the shift began, -1 when not recorded
 };
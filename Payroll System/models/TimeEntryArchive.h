@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string>
+
+// A closed year whose time entries were moved out of the main database into their own file //
+struct TimeEntryArchive {
+	int year;
+	std::string fileName;
+	int entryCount{ 0 };
+	std::string archivedAt;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <vector>
+#include "TimeEntry.h"
+
+// A time entry together with the pay periods containing its date //
+struct TimeEntryCoverage {
+	TimeEntry entry;
+	std::vector<int> payPeriodIDs;
+};
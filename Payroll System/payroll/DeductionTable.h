@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+// What a payroll run needs of one deduction. deductedTotal is what periods ending before the one being  //
+// computed took, so reprocessing a period sees the same cap room however much later periods took since  //
+struct DeductionRule {
+	int id;
+	bool preTax;
+	double percent;
+	double amount;
+	double periodCap;
+	double totalCap;
+	double deductedTotal;
+	double laterTotal; // Recorded for periods ending after the one being computed, part of the running total
+	bool recorded; // A payroll_deductions row exists for the period being computed
+
+	double applied{ 0.0 }; // Set by PayCalculator::calculate
+};
+
+// One payroll_deductions row, with the deduction's running total after it //
+struct AppliedDeduction {
+	int deductionID;
+	int employeeID;
+	double amount;
+	double deductedTotal;
+};
+
+// Every deduction of a run's employees in one flat array, grouped by the position of the employee in //
+// the run: employee i owns rules[first[i]] .. rules[first[i + 1] - 1]                                //
+struct DeductionTable {
+	std::vector<DeductionRule> rules;
+	std::vector<size_t> first{ 0 };
+
+	DeductionRule* forEmployee(size_t employee) {
+		return rules.data() + first[employee];
+	}
+
+	size_t countFor(size_t employee) const {
+		return first[employee + 1] - first[employee];
+	}
+
+	// Appends a row per deduction taken from the employee (or previously recorded for the period) //
+	// and moves the running totals forward, so the next period computed in the run sees them      //
+	void collect(size_t employee, int employeeID, std::vector<AppliedDeduction>& rows) {
+		for (size_t i = first[employee]; i < first[employee + 1]; i++) {
+			DeductionRule& rule = rules[i];
+			if (rule.applied <= 0.0 && !rule.recorded)
+				continue;
+
+			rule.deductedTotal += rule.applied;
+			rows.push_back({ rule.id, employeeID, rule.applied, rule.deductedTotal + rule.laterTotal });
+		}
+	}
+};
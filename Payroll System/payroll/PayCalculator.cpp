@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "PayCalculator.h"
+
+PayCalculator::PayCalculator(const TaxEngine& taxEngine, const PayRules& payRules, const Date& startDate, const Date& endDate)
+	: taxEngine{ taxEngine }, payRules{ payRules }, startDate{ startDate }, periodsPerYear{ 365.0 / (endDate.days - startDate.days + 1) } {}
+
+// Minutes of a shift that fall inside the night window, which may wrap past midnight //
+double PayCalculator::nightMinutes(int shiftStart, double hoursWorked) const {
+	const double shiftEnd = shiftStart + hoursWorked * 60.0;
+	const int windowLength = payRules.nightEnd - payRules.nightStart + (payRules.nightEnd <= payRules.nightStart ? 1440 : 0);
+
+	// A shift of at most 24 hours can touch the windows of the previous, same and next day //
+	double minutes{ 0.0 };
+	for (int dayOffset = -1440; dayOffset <= 1440; dayOffset += 1440) {
+		double windowStart = payRules.nightStart + dayOffset;
+		double overlap = std::min(shiftEnd, windowStart + windowLength) - std::max<double>(shiftStart, windowStart);
+		minutes += std::max(0.0, overlap);
+	}
+
+	return minutes;
+}
+
+// Entries must arrive in date order: daily and weekly overtime only look at hours already added.   //
+// Hours paid as daily overtime do not count towards the weekly limit, so each week pays the larger //
+// of its daily overtime and its hours over the weekly limit, never both for the same hours         //
+void PayCalculator::addEntry(HoursAccumulator& hours, const Date& dateWorked, double hoursWorked, int shiftStart) const {
+	int week = (dateWorked.days - startDate.days) / 7;
+
+	if (dateWorked.days != hours.day) {
+		hours.day = dateWorked.days;
+		hours.dayHours = 0.0;
+	}
+
+	if (week != hours.week) {
+		hours.week = week;
+		hours.weekHours = 0.0;
+	}
+
+	auto hoursAbove = [](double before, double added, double limit) {
+		return std::max(0.0, before + added - limit) - std::max(0.0, before - limit);
+	};
+
+	double dailyOvertime = hoursAbove(hours.dayHours, hoursWorked, payRules.dailyOvertimeAfter);
+	double regularHours = hoursWorked - dailyOvertime;
+	double weeklyOvertime = hoursAbove(hours.weekHours, regularHours, payRules.weeklyOvertimeAfter);
+
+	hours.dayHours += hoursWorked;
+	hours.weekHours += regularHours;
+	hours.overtimeHours += dailyOvertime + weeklyOvertime;
+	hours.hoursWorked += hoursWorked;
+
+	int weekday = dateWorked.weekday();
+	if (weekday == 0 || weekday == 6)
+		hours.weekendHours += hoursWorked;
+
+	if (shiftStart >= 0)
+		hours.nightHours += nightMinutes(shiftStart, hoursWorked) / 60.0;
+}
+
+PayResult PayCalculator::calculate(const HoursAccumulator& hours, double hourlyRate, int taxTable) const {
+	return calculate(hours, hourlyRate, taxTable, nullptr, 0);
+}
+
+// Percent and flat amount, limited by the period cap, the room left under the total cap and the pay available //
+double PayCalculator::deduct(DeductionRule& rule, double grossPay, double available) {
+	double amount = grossPay * rule.percent / 100.0 + rule.amount;
+
+	if (rule.periodCap > 0.0)
+		amount = std::min(amount, rule.periodCap);
+
+	if (rule.totalCap > 0.0)
+		amount = std::min(amount, std::max(0.0, rule.totalCap - rule.deductedTotal));
+
+	rule.applied = std::max(0.0, std::min(amount, available));
+	return rule.applied;
+}
+
+PayResult PayCalculator::calculate(const HoursAccumulator& hours, double hourlyRate, int taxTable, DeductionRule* deductions, size_t deductionCount) const {
+	PayResult result;
+
+	result.hoursWorked = hours.hoursWorked;
+	result.overtimeHours = hours.overtimeHours;
+
+	// Differentials are premiums on top of base pay, overtime replaces the base rate for its hours //
+	double paidHours = (hours.hoursWorked - hours.overtimeHours)
+		+ hours.overtimeHours * payRules.overtimeMultiplier
+		+ hours.weekendHours * (payRules.weekendMultiplier - 1.0)
+		+ hours.nightHours * (payRules.nightMultiplier - 1.0);
+
+	result.grossPay = paidHours * hourlyRate;
+
+	double preTax{ 0.0 };
+	for (size_t i = 0; i < deductionCount; i++) {
+		if (deductions[i].preTax)
+			preTax += deduct(deductions[i], result.grossPay, result.grossPay - preTax);
+	}
+
+	// Tax tables are annual, so period pay is annualized before the brackets are applied //
+	double taxablePay = result.grossPay - preTax;
+	result.tax = taxEngine.computeTax(taxTable, taxablePay * periodsPerYear) / periodsPerYear;
+
+	double postTax{ 0.0 };
+	for (size_t i = 0; i < deductionCount; i++) {
+		if (!deductions[i].preTax)
+			postTax += deduct(deductions[i], result.grossPay, taxablePay - result.tax - postTax);
+	}
+
+	result.deductions = preTax + postTax;
+	result.netPay = result.grossPay - result.tax - result.deductions;
+
+	return result;
+}
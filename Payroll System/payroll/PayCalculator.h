@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../models/Date.h"
+#include "../models/PayResult.h"
+#include "../tax/TaxEngine.h"
+#include "PayRules.h"
+#include "DeductionTable.h"
+
+// Running totals for one employee and pay period, built from that employee's time entries in date order //
+struct HoursAccumulator {
+	int day{ -1 };
+	int week{ -1 };
+	double dayHours{ 0.0 };
+	double weekHours{ 0.0 }; // Hours of the week not already paid as daily overtime
+
+	double hoursWorked{ 0.0 };
+	double overtimeHours{ 0.0 };
+	double weekendHours{ 0.0 };
+	double nightHours{ 0.0 };
+};
+
+// Pay computation shared by every payroll run so they all produce identical amounts //
+class PayCalculator
+{
+private:
+	const TaxEngine& taxEngine;
+	const PayRules& payRules;
+	Date startDate;
+	double periodsPerYear;
+
+	double nightMinutes(int shiftStart, double hoursWorked) const;
+	static double deduct(DeductionRule& rule, double grossPay, double available);
+public:
+	PayCalculator(const TaxEngine& taxEngine, const PayRules& payRules, const Date& startDate, const Date& endDate);
+
+	void addEntry(HoursAccumulator& hours, const Date& dateWorked, double hoursWorked, int shiftStart) const;
+	PayResult calculate(const HoursAccumulator& hours, double hourlyRate, int taxTable) const;
+
+	// Pre-tax deductions come off taxable pay, post-tax ones off what is left after tax. //
+	// The amount taken by each rule is stored in its applied field                        //
+	PayResult calculate(const HoursAccumulator& hours, double hourlyRate, int taxTable, DeductionRule* deductions, size_t deductionCount) const;
+};
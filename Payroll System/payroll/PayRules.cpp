@@ -0,0 +1,90 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include "PayRules.h"
+
+// Times are written HH:MM, returns minutes after midnight or -1 //
+static int parseTimeOfDay(const std::string& text) {
+	int hours, minutes;
+	char separator, trailing;
+	std::istringstream stream(text);
+
+	if (!(stream >> hours >> separator >> minutes) || separator != ':' || hours < 0 || hours > 23 || minutes < 0 || minutes > 59
+		|| stream >> trailing)
+		return -1;
+
+	return hours * 60 + minutes;
+}
+
+static std::string trimField(const std::string& field) {
+	size_t first = field.find_first_not_of(" \t\r");
+	if (first == std::string::npos)
+		return "";
+
+	return field.substr(first, field.find_last_not_of(" \t\r") - first + 1);
+}
+
+static double parseNumber(const std::string& text) {
+	size_t end{ 0 };
+	double value = std::stod(text, &end);
+	if (end != text.size())
+		throw std::invalid_argument(text);
+
+	return value;
+}
+
+// File format (one setting per line): setting,value.                                 //
+// The whole file is read before any rule changes, so a bad line leaves the old rules //
+bool PayRules::loadFromFile(const std::string& fileName) {
+	std::ifstream file(fileName);
+	if (!file) {
+		std::cerr << "Pay rules file " << fileName << " not found, using default overtime rules\n";
+		return false;
+	}
+
+	PayRules parsed = *this;
+	std::string line;
+	int lineNumber{ 0 };
+
+	while (std::getline(file, line)) {
+		lineNumber++;
+
+		line = trimField(line);
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string setting, value, extra;
+		std::getline(fields, setting, ',');
+		std::getline(fields, value, ',');
+
+		setting = trimField(setting);
+		value = trimField(value);
+
+		try {
+			if (std::getline(fields, extra, ','))
+				throw std::invalid_argument(extra);
+
+			if (setting == "daily_overtime_after") parsed.dailyOvertimeAfter = parseNumber(value);
+			else if (setting == "weekly_overtime_after") parsed.weeklyOvertimeAfter = parseNumber(value);
+			else if (setting == "overtime_multiplier") parsed.overtimeMultiplier = parseNumber(value);
+			else if (setting == "weekend_multiplier") parsed.weekendMultiplier = parseNumber(value);
+			else if (setting == "night_multiplier") parsed.nightMultiplier = parseNumber(value);
+			else if (setting == "night_start") parsed.nightStart = parseTimeOfDay(value);
+			else if (setting == "night_end") parsed.nightEnd = parseTimeOfDay(value);
+			else throw std::invalid_argument(setting);
+		}
+		catch (const std::exception&) {
+			std::cerr << "Invalid pay rule on line " << lineNumber << " of " << fileName << ", no pay rules were loaded from it\n";
+			return false;
+		}
+
+		if (parsed.nightStart < 0 || parsed.nightEnd < 0) {
+			std::cerr << "Invalid time on line " << lineNumber << " of " << fileName << " (expected HH:MM), no pay rules were loaded from it\n";
+			return false;
+		}
+	}
+
+	*this = parsed;
+	return true;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+// Overtime and shift-differential settings applied by PayCalculator //
+struct PayRules {
+	double dailyOvertimeAfter{ 8.0 };   // Hours in one day before overtime starts
+	double weeklyOvertimeAfter{ 40.0 }; // Hours in one week (counted from the pay period start) before overtime starts
+	double overtimeMultiplier{ 1.5 };
+
+	double weekendMultiplier{ 1.0 }; // Saturday and Sunday hours
+	double nightMultiplier{ 1.0 };   // Hours between nightStart and nightEnd, needs the shift start time
+	int nightStart{ 22 * 60 };       // Minutes after midnight
+	int nightEnd{ 6 * 60 };
+
+	bool loadFromFile(const std::string& fileName);
+};
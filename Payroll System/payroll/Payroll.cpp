@@ -1,6 +1,24 @@
 #include <iostream>
+#include <algorithm>
 #include "Payroll.h"
 
+bool PayrollManager::loadTaxTables(const std::string& fileName) {
+	if (!taxEngine.loadFromFile(fileName))
+		return false;
+
+	std::cout << "Loaded " << taxEngine.tableCount() << " tax table(s) from " << fileName << '\n';
+	return true;
+}
+
+bool PayrollManager::loadPayRules(const std::string& fileName) {
+	PayRules loaded;
+	if (!loaded.loadFromFile(fileName))
+		return false;
+
+	payRules = loaded;
+	return true;
+}
+
 bool PayrollManager::setupPayroll(Database& db, AuthManager& auth) {
 	bool running{ true };
 	int decision;
@@ -20,8 +38,18 @@ bool PayrollManager::setupPayroll(Database& db, AuthManager& auth) {
 		std::cout << "9 = Activate / Deactivate Employee\n";
 		std::cout << "10 = Add Employee\n";
 		std::cout << "11 = View Employees\n";
-		std::cout << "12 = Logout\n";
-		std::cout << "13 = Exit Program\n";
+		std::cout << "12 = Import Time Entries From File\n";
+		std::cout << "13 = Rebuild Year-To-Date Totals\n";
+		std::cout << "14 = Reprocess Pay Period With Late Time Entries\n";
+		std::cout << "15 = Process All Open Pay Periods\n";
+		std::cout << "16 = Department Labor Cost Report\n";
+		std::cout << "17 = Simulate Payroll (What-If)\n";
+		std::cout << "18 = Generate Pay Stubs\n";
+		std::cout << "19 = Audit Time Entry Pay Period Coverage\n";
+		std::cout << "20 = Employee Deductions\n";
+		std::cout << "21 = Archive Time Entries Of A Closed Year\n";
+		std::cout << "22 = Logout\n";
+		std::cout << "23 = Exit Program\n";
 		std::cout << "Input: ";
 
 		if (!(std::cin >> decision)) {
@@ -81,6 +109,46 @@ bool PayrollManager::setupPayroll(Database& db, AuthManager& auth) {
 
 				break;
 			case 12:
+				importTimeEntries(db);
+
+				break;
+			case 13:
+				rebuildYearToDateTotals(db);
+
+				break;
+			case 14:
+				reprocessPayroll(db);
+
+				break;
+			case 15:
+				processOpenPayrolls(db);
+
+				break;
+			case 16:
+				viewLaborCostReport(db);
+
+				break;
+			case 17:
+				simulatePayroll(db);
+
+				break;
+			case 18:
+				generatePayStubs(db);
+
+				break;
+			case 19:
+				auditTimeEntryCoverage(db);
+
+				break;
+			case 20:
+				manageDeductions(db);
+
+				break;
+			case 21:
+				archiveTimeEntries(db);
+
+				break;
+			case 22:
 				auth.logout();
 
 				std::cout << "\nUser Successfully Logged Out\n";
@@ -88,13 +156,13 @@ bool PayrollManager::setupPayroll(Database& db, AuthManager& auth) {
 
 				running = false;
 				break;
-			case 13:
+			case 23:
 				std::cout << "\nExiting Program\n";
 				Utils::Pause();
 
 				return false;
 			default:
-				std::cout << "\nInvalid Input: Number must be between (1 - 13)\n";
+				std::cout << "\nInvalid Input: Number must be between (1 - 23)\n";
 				Utils::Pause();
 		}
 	}
@@ -104,33 +172,76 @@ bool PayrollManager::setupPayroll(Database& db, AuthManager& auth) {
 
 void PayrollManager::createPayPeriod(Database& db) {
 	system("cls");
-	std::regex date_regex(R"(\d{2}-\d{2}-\d{4})");
-	std::string startDate, endDate;
+	std::string startInput, endInput;
+	Date startDate, endDate;
 
 	std::cout << "**** Create Pay Period ****\n";
 	std::cout << "Date Format: 00-00-0000 || day-month-year\n\n";
 
 	std::cout << "Start Date: ";
-	std::getline(std::cin >> std::ws, startDate);
-	if (!std::regex_match(startDate, date_regex)) {
-		std::cout << "\nInvalid Date Format! (00-00-0000 || 01-01-2026)\n";
+	std::getline(std::cin >> std::ws, startInput);
+	if (!Date::parse(startInput, startDate)) {
+		std::cout << "\nInvalid Date! (00-00-0000 || 01-01-2026)\n";
 		Utils::Pause();
 
 		return;
 	}
 
 	std::cout << "End Date: ";
-	std::getline(std::cin >> std::ws, endDate);
-	if (!std::regex_match(endDate, date_regex)) {
-		std::cout << "\nInvalid Date Format! (00-00-0000 || 01-01-2026)\n";
+	std::getline(std::cin >> std::ws, endInput);
+	if (!Date::parse(endInput, endDate)) {
+		std::cout << "\nInvalid Date! (00-00-0000 || 01-01-2026)\n";
 		Utils::Pause();
 
 		return;
 	}
 
-	// Fromating Date (day-month-year --> year-month-day || 00-00-0000 --> 0000-00-00) //
-	Utils::formatDate(startDate);
-	Utils::formatDate(endDate);
+	if (endDate < startDate) {
+		std::cout << "\nEnd date cannot be before the start date\n";
+		Utils::Pause();
+
+		return;
+	}
+
+	const PayPeriodIndex& payPeriods = db.getPayPeriodIndex();
+
+	int overlappingID = payPeriods.findOverlap(startDate, endDate);
+	if (overlappingID != 0) {
+		std::cout << "\nPay period overlaps pay period ID " << overlappingID << ", hours in both would be paid twice\n";
+		Utils::Pause();
+
+		return;
+	}
+
+	// Hours worked on days no pay period covers are never paid, so a gap needs confirmation //
+	Date gapStart, gapEnd;
+	bool hasGap{ false };
+
+	if (payPeriods.gapBefore(startDate, gapStart, gapEnd)) {
+		std::cout << "\nWarning: " << gapStart.toString() << " to " << gapEnd.toString() << " is not covered by any pay period";
+		hasGap = true;
+	}
+
+	if (payPeriods.gapAfter(endDate, gapStart, gapEnd)) {
+		std::cout << "\nWarning: " << gapStart.toString() << " to " << gapEnd.toString() << " is not covered by any pay period";
+		hasGap = true;
+	}
+
+	if (hasGap) {
+		char confirmCreation;
+		std::cout << "\nCreate the pay period anyway? (y/n)\n";
+		std::cout << "Input: ";
+		if (!(std::cin >> confirmCreation) || std::tolower(confirmCreation) != 'y') {
+			std::cout << "\nPay Period Not Created\n";
+
+			Utils::ClearInputBuffer();
+			Utils::Pause();
+
+			return;
+		}
+
+		Utils::ClearInputBuffer();
+	}
 
 	bool success = db.addPayPeriod(startDate, endDate);
 	std::cout << '\n' << (success ? "Pay period successfully Created" : "Failed to create pay period!") << '\n';
@@ -204,8 +315,8 @@ void PayrollManager::viewPayPeriods(Database& db, bool waitForUserInput) {
 	for (const PayPeriod& period : payPeriods) {
 		std::cout << std::left
 			<< std::setw(5) << period.id
-			<< std::setw(15) << period.startDate
-			<< std::setw(15) << period.endDate
+			<< std::setw(15) << period.startDate.toString()
+			<< std::setw(15) << period.endDate.toString()
 			<< std::setw(10) << (period.isProcessed() ? "Processed" : "Open") << '\n';
 	}
 
@@ -232,12 +343,209 @@ void PayrollManager::processPayroll(Database& db) {
 	}
 
 	std::cout << "\nStarting payroll processing for pay period: " << payPeriodID << '\n';
-	bool success = db.insertPayrollForPayPeriod(payPeriodID);
+	bool success = db.insertPayrollForPayPeriod(payPeriodID, taxEngine, payRules);
 	std::cout << '\n' << (success ? "Payroll successfully processed" : "Failed to process payroll") << '\n';
 	Utils::ClearInputBuffer();
 	Utils::Pause();
 }
 
+void PayrollManager::reprocessPayroll(Database& db) {
+	system("cls");
+	int payPeriodID;
+
+	std::cout << "**** Reprocess Pay Period With Late Time Entries ****\n";
+	std::cout << "Only employees whose time entries changed since the period was processed are recalculated\n\n";
+	viewPayPeriods(db, false);
+
+	std::cout << "Enter Pay Period ID: ";
+	if (!(std::cin >> payPeriodID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	int employeesUpdated{ 0 };
+	bool success = db.reprocessPayPeriod(payPeriodID, taxEngine, payRules, employeesUpdated);
+	if (success)
+		std::cout << "\nPay period reprocessed: " << employeesUpdated << " employee payroll record(s) updated\n";
+	else
+		std::cout << "\nFailed to reprocess pay period\n";
+
+	Utils::ClearInputBuffer();
+	Utils::Pause();
+}
+
+void PayrollManager::processOpenPayrolls(Database& db) {
+	system("cls");
+	char confirmRun;
+
+	std::cout << "**** Process All Open Pay Periods ****\n\n";
+	viewPayPeriods(db, false);
+
+	std::cout << "Process every open pay period above in one run? (y/n)\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> confirmRun) || std::tolower(confirmRun) != 'y') {
+		std::cout << "\nPayroll Run Cancelled\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	int periodsProcessed{ 0 }, recordsWritten{ 0 };
+	bool success = db.processOpenPayPeriods(taxEngine, payRules, periodsProcessed, recordsWritten);
+	if (success)
+		std::cout << "\nProcessed " << periodsProcessed << " pay period(s), " << recordsWritten << " payroll record(s) written\n";
+	else
+		std::cout << "\nFailed to process open pay periods, nothing was written\n";
+
+	Utils::ClearInputBuffer();
+	Utils::Pause();
+}
+
+void PayrollManager::simulatePayroll(Database& db) {
+	system("cls");
+	int payPeriodID;
+	PayrollOverrides overrides;
+
+	std::cout << "**** Simulate Payroll (What-If) ****\n";
+	std::cout << "Computes a pay period with changed rates, tax tables or pay rules, nothing is saved\n\n";
+	viewPayPeriods(db, false);
+
+	std::cout << "Enter Pay Period ID: ";
+	if (!(std::cin >> payPeriodID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	std::cout << "Rate Change For All Employees In % (0 = none): ";
+	if (!(std::cin >> overrides.rateChangePercent) || overrides.rateChangePercent <= -100.0) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	int employeeID;
+	std::cout << "Employee ID With A New Hourly Rate (0 = none): ";
+	if (!(std::cin >> employeeID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	if (employeeID > 0) {
+		double hourlyRate;
+		std::cout << "New Hourly Rate: ";
+		if (!(std::cin >> hourlyRate) || hourlyRate < 0.0) {
+			std::cout << "\nInvalid Input\n";
+
+			Utils::ClearInputBuffer();
+			Utils::Pause();
+
+			return;
+		}
+
+		overrides.hourlyRates[employeeID] = hourlyRate;
+	}
+
+	Utils::ClearInputBuffer();
+
+	// Alternative tables and rules are layered over copies of the current ones //
+	std::string fileName;
+	TaxEngine simulatedTaxEngine = taxEngine;
+	std::cout << "Tax Table File (leave empty to keep the current tables): ";
+	std::getline(std::cin, fileName);
+	if (!fileName.empty() && !simulatedTaxEngine.loadFromFile(fileName)) {
+		Utils::Pause();
+		return;
+	}
+
+	PayRules simulatedPayRules = payRules;
+	std::cout << "Pay Rules File (leave empty to keep the current rules): ";
+	std::getline(std::cin, fileName);
+	if (!fileName.empty() && !simulatedPayRules.loadFromFile(fileName)) {
+		Utils::Pause();
+		return;
+	}
+
+	std::vector<PayrollSimulation> results;
+	if (!db.simulatePayroll(payPeriodID, simulatedTaxEngine, simulatedPayRules, overrides, results)) {
+		std::cout << "\nFailed to simulate payroll\n";
+		Utils::Pause();
+
+		return;
+	}
+
+	std::cout << '\n' << std::left
+		<< std::setw(12) << "Employee ID"
+		<< std::setw(15) << "Current Gross"
+		<< std::setw(15) << "Simulated"
+		<< std::setw(15) << "Gross Change"
+		<< std::setw(15) << "Current Net"
+		<< std::setw(15) << "Simulated"
+		<< std::setw(15) << "Net Change"
+		<< '\n';
+	std::cout << "-------------------------------------------------------------------------------------------------------\n";
+
+	auto money = [](double amount) {
+		std::ostringstream text;
+		text << "$" << std::fixed << std::setprecision(2) << amount;
+		return text.str();
+	};
+
+	PayResult currentTotal, simulatedTotal;
+	for (const PayrollSimulation& result : results) {
+		currentTotal.grossPay += result.current.grossPay;
+		currentTotal.netPay += result.current.netPay;
+		simulatedTotal.grossPay += result.simulated.grossPay;
+		simulatedTotal.netPay += result.simulated.netPay;
+	}
+
+	for (size_t i = 0; i < results.size(); i++) {
+		const PayrollSimulation& result = results[i];
+
+		std::cout << std::left
+			<< std::setw(12) << result.employeeID
+			<< std::setw(15) << (result.hasCurrent ? money(result.current.grossPay) : "-")
+			<< std::setw(15) << money(result.simulated.grossPay)
+			<< std::setw(15) << money(result.simulated.grossPay - result.current.grossPay)
+			<< std::setw(15) << (result.hasCurrent ? money(result.current.netPay) : "-")
+			<< std::setw(15) << money(result.simulated.netPay)
+			<< std::setw(15) << money(result.simulated.netPay - result.current.netPay)
+			<< '\n';
+
+		if ((i + 1) % pageSize == 0 && i + 1 < results.size() && !Utils::NextPage())
+			break;
+	}
+
+	std::cout << "-------------------------------------------------------------------------------------------------------\n";
+	std::cout << std::left
+		<< std::setw(12) << "Total"
+		<< std::setw(15) << money(currentTotal.grossPay)
+		<< std::setw(15) << money(simulatedTotal.grossPay)
+		<< std::setw(15) << money(simulatedTotal.grossPay - currentTotal.grossPay)
+		<< std::setw(15) << money(currentTotal.netPay)
+		<< std::setw(15) << money(simulatedTotal.netPay)
+		<< std::setw(15) << money(simulatedTotal.netPay - currentTotal.netPay)
+		<< "\n\n";
+
+	Utils::Pause();
+}
+
 void PayrollManager::viewPayrollRecords(Database& db) {
 	system("cls");
 
@@ -252,8 +560,32 @@ void PayrollManager::viewPayrollRecords(Database& db) {
 		<< '\n';
 	std::cout << "--------------------------------------------------------------------------------------\n";
 
-	std::vector<Payroll> payrollRecords = db.getPayrollRecords();
-	if (payrollRecords.empty()) {
+	PayrollCursor cursor;
+	int rowCount, totalRows{ 0 };
+	do {
+		rowCount = db.getPayrollRecordsPage(cursor, pageSize, [](const Payroll& record) {
+			std::string payPeriod = record.startDate.toString() + " - " + record.endDate.toString();
+
+			std::ostringstream grossPay, netPay;
+			grossPay << "$" << std::fixed << std::setprecision(2) << record.grossPay;
+			netPay << "$" << std::fixed << std::setprecision(2) << record.netPay;
+
+			std::cout << std::left
+				<< std::setw(12) << record.employeeID
+				<< std::setw(15) << record.firstName
+				<< std::setw(15) << record.lastName
+				<< std::setw(25) << payPeriod
+				<< std::setw(12) << grossPay.str()
+				<< std::setw(12) << netPay.str()
+				<< '\n';
+
+			return true;
+		});
+
+		totalRows += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == pageSize && Utils::NextPage());
+
+	if (totalRows == 0) {
 		std::cout << "No Payroll Records Found\n\n";
 
 		Utils::ClearInputBuffer();
@@ -262,24 +594,6 @@ void PayrollManager::viewPayrollRecords(Database& db) {
 		return;
 	}
 
-	for (Payroll& record : payrollRecords) {
-		// Fromating Date (day-month-year --> year-month-day || 00-00-0000 --> 0000-00-00) //
-		std::string payPeriod = record.startDate + " - " + record.endDate;
-
-		std::ostringstream grossPay, netPay;
-		grossPay << "$" << std::fixed << std::setprecision(2) << record.grossPay;
-		netPay << "$" << std::fixed << std::setprecision(2) << record.netPay;
-
-		std::cout << std::left
-			<< std::setw(12) << record.employeeID
-			<< std::setw(15) << record.firstName
-			<< std::setw(15) << record.lastName
-			<< std::setw(25) << payPeriod 
-			<< std::setw(12) << grossPay.str()
-			<< std::setw(12) << netPay.str()
-			<< '\n';
-	}
-
 	Utils::ClearInputBuffer();
 	Utils::Pause();
 }
@@ -289,10 +603,70 @@ void PayrollManager::viewEmployeePayrollHistory(Database& db) {
 	int employeeID;
 
 	std::cout << "**** View Employee Payroll History ****\n\n";
-	viewEmployees(db, false);
+	if (!pickEmployee(db, employeeID))
+		return;
 
-	std::cout << "Employee ID: ";
-	if (!(std::cin >> employeeID)) {
+	std::cout << '\n' << std::left << std::setw(5) << "ID" << std::setw(15) << "Start Date"
+		<< std::setw(15) << "End Date" << std::setw(25) << "Processed At"
+		<< std::setw(15) << "Gross Pay" << std::setw(15) << "Net Pay" << '\n';
+	std::cout << "------------------------------------------------------------------------------------------\n";
+
+	Utils::ClearInputBuffer();
+
+	EmployeePayrollCursor cursor;
+	int rowCount;
+	do {
+		rowCount = db.getEmployeePayrollHistoryPage(employeeID, cursor, pageSize, [](const EmployeePayroll& payroll) {
+			std::ostringstream grossPay, netPay;
+			grossPay << "$" << std::fixed << std::setprecision(2) << payroll.grossPay;
+			netPay << "$" << std::fixed << std::setprecision(2) << payroll.netPay;
+
+			std::cout << std::left
+				<< std::setw(5) << payroll.payPeriodID
+				<< std::setw(15) << payroll.startDate.toString()
+				<< std::setw(15) << payroll.endDate.toString()
+				<< std::setw(25) << payroll.processedAt
+				<< std::setw(15) << grossPay.str()
+				<< std::setw(15) << netPay.str() << '\n';
+
+			return true;
+		});
+	} while (rowCount == pageSize && Utils::NextPage());
+
+	PayrollYtd ytd;
+	int currentYear = Date::today().year();
+	if (db.getPayrollYtd(employeeID, currentYear, ytd)) {
+		std::cout << "\nYear To Date (" << currentYear << "): " << std::fixed << std::setprecision(2)
+			<< "Hours " << ytd.hoursWorked
+			<< " | Gross $" << ytd.grossPay
+			<< " | Tax $" << ytd.tax
+			<< " | Net $" << ytd.netPay << '\n';
+		std::cout.unsetf(std::ios::floatfield);
+	}
+
+	std::cout << '\n';
+	Utils::Pause();
+}
+
+void PayrollManager::rebuildYearToDateTotals(Database& db) {
+	system("cls");
+
+	std::cout << "**** Rebuild Year-To-Date Totals ****\n\n";
+	std::cout << "Recalculating totals from every payroll record . . .\n";
+
+	bool success = db.rebuildPayrollYtd();
+	std::cout << '\n' << (success ? "Year-to-date totals successfully rebuilt" : "Failed to rebuild year-to-date totals") << '\n';
+	Utils::Pause();
+}
+
+void PayrollManager::viewLaborCostReport(Database& db) {
+	system("cls");
+
+	std::cout << "**** Department Labor Cost Report ****\n\n";
+
+	int year;
+	std::cout << "Year (eg. 2026): ";
+	if (!(std::cin >> year)) {
 		std::cout << "\nInvalid Input\n";
 
 		Utils::ClearInputBuffer();
@@ -301,27 +675,124 @@ void PayrollManager::viewEmployeePayrollHistory(Database& db) {
 		return;
 	}
 
-	std::cout << '\n' << std::left << std::setw(5) << "ID" << std::setw(15) << "Start Date"
-		<< std::setw(15) << "End Date" << std::setw(25) << "Processed At"
-		<< std::setw(15) << "Gross Pay" << std::setw(15) << "Net Pay" << '\n';
-	std::cout << "------------------------------------------------------------------------------------------\n";
+	int measure;
+	std::cout << "\n1 = Gross Pay\n2 = Net Pay\n3 = Tax\n4 = Hours Worked\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> measure) || measure < 1 || measure > 4) {
+		std::cout << "\nInvalid Input: Number must be between (1 - 4)\n";
 
-	std::vector<EmployeePayroll> employee_payrolls = db.getEmployeePayrollHistory(employeeID);
-	for (EmployeePayroll& payroll : employee_payrolls) {
-		std::ostringstream grossPay, netPay;
-		grossPay << "$" << std::fixed << std::setprecision(2) << payroll.grossPay;
-		netPay << "$" << std::fixed << std::setprecision(2) << payroll.netPay;
+		Utils::ClearInputBuffer();
+		Utils::Pause();
 
-		std::cout << std::left
-			<< std::setw(5) << payroll.payPeriodID
-			<< std::setw(15) << payroll.startDate
-			<< std::setw(15) << payroll.endDate
-			<< std::setw(25) << payroll.processedAt
-			<< std::setw(15) << grossPay.str()
-			<< std::setw(15) << netPay.str() << '\n';
+		return;
 	}
 
 	Utils::ClearInputBuffer();
+
+	LaborCostReport report;
+	if (!report.load(db, year)) {
+		Utils::Pause();
+		return;
+	}
+
+	if (report.empty()) {
+		std::cout << "\nNo processed payroll found for " << year << "\n\n";
+		Utils::Pause();
+
+		return;
+	}
+
+	const LaborCostReport::Measure measures[] = {
+		LaborCostReport::Measure::GrossPay,
+		LaborCostReport::Measure::NetPay,
+		LaborCostReport::Measure::Tax,
+		LaborCostReport::Measure::HoursWorked
+	};
+
+	std::cout << '\n';
+	report.render(std::cout, db.getDepartments(), measures[measure - 1]);
+	std::cout << '\n';
+
+	Utils::Pause();
+}
+
+void PayrollManager::generatePayStubs(Database& db) {
+	system("cls");
+	int payPeriodID;
+	char destination;
+	std::string path;
+
+	std::cout << "**** Generate Pay Stubs ****\n\n";
+	viewPayPeriods(db, false);
+
+	std::cout << "Enter Pay Period ID: ";
+	if (!(std::cin >> payPeriodID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	std::cout << "\nd = One file per employee in a directory\na = Single archive file\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> destination) || (std::tolower(destination) != 'd' && std::tolower(destination) != 'a')) {
+		std::cout << "\nInvalid Input: Must be d or a\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	bool toDirectory = std::tolower(destination) == 'd';
+	std::cout << (toDirectory ? "Output directory: " : "Archive file: ");
+	std::getline(std::cin >> std::ws, path);
+
+	PayStubGenerator generator(db.getDepartments());
+	int stubCount{ 0 };
+
+	auto start = std::chrono::steady_clock::now();
+	bool success = generator.generate(db, payPeriodID, toDirectory ? PayStubGenerator::Output::Directory : PayStubGenerator::Output::Archive, path, stubCount);
+	long long milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	if (success && stubCount == 0)
+		std::cout << "\nNo payroll records found for pay period " << payPeriodID << '\n';
+	else
+		std::cout << '\n' << (success ? "Pay stubs written: " : "Failed after writing pay stubs: ") << stubCount
+			<< " (" << milliseconds << " ms)\n";
+
+	Utils::Pause();
+}
+
+void PayrollManager::auditTimeEntryCoverage(Database& db) {
+	system("cls");
+	std::cout << "**** Audit Time Entry Pay Period Coverage ****\n";
+	std::cout << "Time entries in no pay period are never paid, entries in several are paid more than once\n\n";
+
+	std::cout << std::left << std::setw(5) << "ID" << std::setw(15) << "Date Worked" << std::setw(15) << "Hours Worked" << "Pay Periods" << '\n';
+	std::cout << "------------------------------------------------------\n";
+
+	int shownRows{ 0 };
+	int rowCount = db.auditTimeEntryCoverage([&shownRows](const TimeEntryCoverage& coverage) {
+		std::string payPeriods;
+		for (int payPeriodID : coverage.payPeriodIDs)
+			payPeriods += (payPeriods.empty() ? "" : ", ") + std::to_string(payPeriodID);
+
+		std::cout << std::left
+			<< std::setw(5) << coverage.entry.employeeID
+			<< std::setw(15) << coverage.entry.dateWorked.toString()
+			<< std::setw(15) << coverage.entry.hoursWorked
+			<< (payPeriods.empty() ? "none" : payPeriods) << '\n';
+
+		return ++shownRows % pageSize != 0 || Utils::NextPage();
+	});
+
+	if (rowCount == 0)
+		std::cout << "Every time entry falls in exactly one pay period\n";
+
+	std::cout << '\n';
 	Utils::Pause();
 }
 
@@ -334,35 +805,59 @@ void PayrollManager::viewTimeEntries(Database& db, bool waitForUserInput) {
 	std::cout << std::left << std::setw(5) << "ID" << std::setw(15) << "Date Worked" << std::setw(15) << "Hours Worked" << '\n';
 	std::cout << "-----------------------------------\n";
 
-	std::vector<TimeEntry> TimeEntries = db.getTimeEntries();
-	if (TimeEntries.empty()) {
+	TimeEntryCursor cursor;
+	int rowCount, totalRows{ 0 };
+	do {
+		rowCount = db.getTimeEntriesPage(cursor, pageSize, [](const TimeEntry& entry) {
+			std::cout << std::left
+				<< std::setw(5) << entry.employeeID
+				<< std::setw(15) << entry.dateWorked.toString()
+				<< std::setw(15) << entry.hoursWorked << '\n';
+
+			return true;
+		});
+
+		totalRows += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == pageSize && (!waitForUserInput || Utils::NextPage()));
+
+	if (totalRows == 0) {
 		std::cout << "No Time Entries Found\n\n";
 		Utils::Pause();
 
 		return;
 	}
 
-	for (TimeEntry& entry : TimeEntries) {
-		std::cout << std::left
-			<< std::setw(5) << entry.employeeID
-			<< std::setw(15) << entry.dateWorked
-			<< std::setw(15) << entry.hoursWorked << '\n';
-	}
-
 	std::cout << "\n";
 	if (waitForUserInput) { Utils::Pause(); }
 }
 
-void PayrollManager::enterEmployeeHours(Database& db) {
+void PayrollManager::archiveTimeEntries(Database& db) {
 	system("cls");
-	TimeEntry timeEntry;
-	std::regex date_regex(R"(\d{2}-\d{2}-\d{4})");
+	int year;
+	char confirmArchive;
 
-	std::cout << "**** Enter Employee Hours ****\n\n";
-	viewEmployees(db, false);
+	std::cout << "**** Archive Time Entries Of A Closed Year ****\n";
+	std::cout << "Moves a year's time entries into their own database file once all of its pay periods are processed.\n";
+	std::cout << "Payroll records stay in place and archived entries are still read by reprocessing and simulations.\n\n";
 
-	std::cout << "\nEmployee ID: ";
-	if (!(std::cin >> timeEntry.employeeID)) {
+	std::vector<TimeEntryArchive> archives = db.getTimeEntryArchives();
+
+	std::cout << std::left << std::setw(8) << "Year" << std::setw(12) << "Entries" << std::setw(22) << "Archived At" << "File" << '\n';
+	std::cout << "------------------------------------------------------------------------\n";
+
+	for (const TimeEntryArchive& archive : archives) {
+		std::cout << std::left
+			<< std::setw(8) << archive.year
+			<< std::setw(12) << archive.entryCount
+			<< std::setw(22) << archive.archivedAt
+			<< archive.fileName << '\n';
+	}
+
+	if (archives.empty())
+		std::cout << "No Archived Years\n";
+
+	std::cout << "\nYear to archive: ";
+	if (!(std::cin >> year)) {
 		std::cout << "\nInvalid Input\n";
 
 		Utils::ClearInputBuffer();
@@ -371,10 +866,39 @@ void PayrollManager::enterEmployeeHours(Database& db) {
 		return;
 	}
 
+	std::cout << "\nArchive all time entries of " << year << "? Entries for that year can no longer be added or changed (y/n)\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> confirmArchive) || std::tolower(confirmArchive) != 'y') {
+		std::cout << "\nArchive Cancelled\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	Utils::ClearInputBuffer();
+
+	int entriesMoved{ 0 };
+	if (db.archiveTimeEntries(year, entriesMoved))
+		std::cout << "\n" << entriesMoved << " time entries of " << year << " archived\n";
+
+	Utils::Pause();
+}
+
+void PayrollManager::enterEmployeeHours(Database& db) {
+	system("cls");
+	TimeEntry timeEntry;
+	std::string dateInput;
+
+	std::cout << "**** Enter Employee Hours ****\n\n";
+	if (!pickEmployee(db, timeEntry.employeeID))
+		return;
+
 	std::cout << "Date Worked: ";
-	std::getline(std::cin >> std::ws, timeEntry.dateWorked);
-	if (!std::regex_match(timeEntry.dateWorked, date_regex)) {
-		std::cout << "\nInvalid Date Format! (00-00-0000 || 01-01-2026)\n";
+	std::getline(std::cin >> std::ws, dateInput);
+	if (!Date::parse(dateInput, timeEntry.dateWorked)) {
+		std::cout << "\nInvalid Date! (00-00-0000 || 01-01-2026)\n";
 		Utils::Pause();
 
 		return;
@@ -390,28 +914,50 @@ void PayrollManager::enterEmployeeHours(Database& db) {
 		return;
 	}
 
-	// Fromating Date (day-month-year --> year-month-day || 00-00-0000 --> 0000-00-00) //
-	Utils::formatDate(timeEntry.dateWorked);
+	Utils::ClearInputBuffer();
+
+	// Only needed for night shift differentials //
+	std::string shiftInput;
+	std::cout << "Shift Start (00:00 || hour:minute, leave empty if unknown): ";
+	std::getline(std::cin, shiftInput);
+
+	if (!shiftInput.empty()) {
+		int hour, minute;
+		char separator;
+		std::istringstream shiftStream(shiftInput);
+
+		if (!(shiftStream >> hour >> separator >> minute) || separator != ':' || hour < 0 || hour > 23 || minute < 0 || minute > 59) {
+			std::cout << "\nInvalid Time! (00:00 || 22:30)\n";
+			Utils::Pause();
+
+			return;
+		}
+
+		timeEntry.shiftStart = hour * 60 + minute;
+	}
 
 	bool success = db.addTimeEntry(timeEntry);
 	if (success)
 		std::cout << "\nTime Entry Successfully Added\n";
 
-	Utils::ClearInputBuffer();
 	Utils::Pause();
 }
 
-void PayrollManager::toggleEmployeeStatus(Database& db) {
+void PayrollManager::importTimeEntries(Database& db) {
 	system("cls");
-	int employeeID;
-	char isActive;
+	std::string fileName;
+	char mode;
 
-	std::cout << "**** Activate / Deactivate Employee Status ****\n\n";
-	viewEmployees(db, false);
+	std::cout << "**** Import Time Entries From File ****\n";
+	std::cout << "File Format: employee_id,date_worked,hours_worked[,shift_start] (one punch per line)\n\n";
 
-	std::cout << "Employee ID: ";
-	if (!(std::cin >> employeeID)) {
-		std::cout << "\nInvalid Input\n";
+	std::cout << "File Path: ";
+	std::getline(std::cin >> std::ws, fileName);
+
+	std::cout << "Existing entry for the same employee and day: (u = update hours, r = reject line)\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> mode) || (std::tolower(mode) != 'u' && std::tolower(mode) != 'r')) {
+		std::cout << "\nInvalid Input: Input Must Be 'u' or 'r'\n";
 
 		Utils::ClearInputBuffer();
 		Utils::Pause();
@@ -419,6 +965,30 @@ void PayrollManager::toggleEmployeeStatus(Database& db) {
 		return;
 	}
 
+	std::string rejectFileName = fileName + ".rejected";
+	ImportSummary summary;
+
+	std::cout << "\nImporting . . .\n";
+	bool success = db.importTimeEntries(fileName, std::tolower(mode) == 'u', rejectFileName, summary);
+
+	std::cout << '\n' << (success ? "Import completed" : "Import stopped") << '\n';
+	std::cout << "Imported: " << summary.imported << " entries in " << summary.batches << " transaction(s)\n";
+	if (summary.rejected > 0)
+		std::cout << "Rejected: " << summary.rejected << " line(s) written to " << rejectFileName << '\n';
+
+	Utils::ClearInputBuffer();
+	Utils::Pause();
+}
+
+void PayrollManager::toggleEmployeeStatus(Database& db) {
+	system("cls");
+	int employeeID;
+	char isActive;
+
+	std::cout << "**** Activate / Deactivate Employee Status ****\n\n";
+	if (!pickEmployee(db, employeeID))
+		return;
+
 	std::cout << "Activate (y/n): ";
 	if (!(std::cin >> isActive)) {
 		std::cout << "\nInvalid Input\n";
@@ -447,6 +1017,159 @@ void PayrollManager::toggleEmployeeStatus(Database& db) {
 	Utils::Pause();
 }
 
+void PayrollManager::manageDeductions(Database& db) {
+	system("cls");
+	int employeeID;
+
+	std::cout << "**** Employee Deductions ****\n\n";
+
+	std::cout << "Employee ID: ";
+	if (!(std::cin >> employeeID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	std::vector<Deduction> deductions = db.getEmployeeDeductions(employeeID);
+
+	std::cout << '\n' << std::left << std::setw(5) << "ID" << std::setw(13) << "Kind" << std::setw(20) << "Name" << std::setw(9) << "Pre-Tax"
+		<< std::setw(10) << "Percent" << std::setw(10) << "Amount" << std::setw(12) << "Period Cap" << std::setw(12) << "Total Cap"
+		<< std::setw(12) << "Deducted" << "Status" << '\n';
+	std::cout << "------------------------------------------------------------------------------------------------------------\n";
+
+	auto cap = [](double value) {
+		std::ostringstream text;
+		if (value > 0.0)
+			text << value;
+		else
+			text << '-';
+
+		return text.str();
+	};
+
+	for (const Deduction& deduction : deductions) {
+		std::cout << std::left
+			<< std::setw(5) << deduction.id
+			<< std::setw(13) << deduction.kind
+			<< std::setw(20) << deduction.name
+			<< std::setw(9) << (deduction.preTax ? "yes" : "no")
+			<< std::setw(10) << deduction.percent
+			<< std::setw(10) << deduction.amount
+			<< std::setw(12) << cap(deduction.periodCap)
+			<< std::setw(12) << cap(deduction.totalCap)
+			<< std::setw(12) << deduction.deductedTotal
+			<< (deduction.isActive ? "Active" : "Inactive") << '\n';
+	}
+
+	if (deductions.empty())
+		std::cout << "No Deductions Found\n";
+
+	char action;
+	std::cout << "\na = Add Deduction, d = Deactivate Deduction, any other key = Back\n";
+	std::cout << "Input: ";
+	if (!(std::cin >> action)) {
+		Utils::ClearInputBuffer();
+		return;
+	}
+
+	action = std::tolower(action);
+	if (action == 'a') {
+		addDeduction(db, employeeID);
+		return;
+	}
+
+	if (action != 'd') {
+		Utils::ClearInputBuffer();
+		return;
+	}
+
+	int deductionID;
+	std::cout << "Deduction ID: ";
+	if (!(std::cin >> deductionID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	if (db.setDeductionStatus(deductionID, false))
+		std::cout << "\nDeduction Successfully Deactivated\n";
+
+	Utils::ClearInputBuffer();
+	Utils::Pause();
+}
+
+void PayrollManager::addDeduction(Database& db, int employeeID) {
+	Deduction deduction;
+	deduction.employeeID = employeeID;
+
+	std::cout << "\nKind (pension, health, garnishment or other): ";
+	std::getline(std::cin >> std::ws, deduction.kind);
+	for (char& c : deduction.kind)
+		c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+
+	if (deduction.kind != "pension" && deduction.kind != "health" && deduction.kind != "garnishment" && deduction.kind != "other") {
+		std::cout << "\nInvalid Kind: Must be pension, health, garnishment or other\n";
+		Utils::Pause();
+
+		return;
+	}
+
+	std::cout << "Name: ";
+	std::getline(std::cin >> std::ws, deduction.name);
+
+	char preTax;
+	std::cout << "Taken before tax? (y/n): ";
+	if (!(std::cin >> preTax) || (std::tolower(preTax) != 'y' && std::tolower(preTax) != 'n')) {
+		std::cout << "\nInvalid Input: Must be y or n\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	deduction.preTax = std::tolower(preTax) == 'y';
+
+	std::cout << "Percent of gross pay (0 for none): ";
+	bool valid = static_cast<bool>(std::cin >> deduction.percent) && deduction.percent >= 0.0 && deduction.percent <= 100.0;
+
+	if (valid) {
+		std::cout << "Flat amount per pay period (0 for none): ";
+		valid = static_cast<bool>(std::cin >> deduction.amount) && deduction.amount >= 0.0;
+	}
+
+	if (valid) {
+		std::cout << "Maximum per pay period (0 for no cap): ";
+		valid = static_cast<bool>(std::cin >> deduction.periodCap) && deduction.periodCap >= 0.0;
+	}
+
+	if (valid) {
+		std::cout << "Maximum in total, eg. the amount owed on a garnishment (0 for no cap): ";
+		valid = static_cast<bool>(std::cin >> deduction.totalCap) && deduction.totalCap >= 0.0;
+	}
+
+	if (!valid) {
+		std::cout << "\nInvalid Input: Percent must be between 0 and 100 and amounts cannot be negative\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return;
+	}
+
+	if (db.addDeduction(deduction))
+		std::cout << "\nDeduction Successfully Added\n";
+
+	Utils::ClearInputBuffer();
+	Utils::Pause();
+}
+
 void PayrollManager::createEmployee(Database& db) {
 	system("cls");
 	Employee emp;
@@ -458,11 +1181,29 @@ void PayrollManager::createEmployee(Database& db) {
 	std::cout << "Last Name: ";
 	std::getline(std::cin >> std::ws, emp.lastName);
 
+	std::string department;
 	std::cout << "Department: ";
-	std::getline(std::cin >> std::ws, emp.department);
+	std::getline(std::cin >> std::ws, department);
 
+	std::string employmentType;
 	std::cout << "Employment Type (eg. full-time or part-time): ";
-	std::getline(std::cin >> std::ws, emp.employmentType);
+	std::getline(std::cin >> std::ws, employmentType);
+
+	std::cout << "Tax Jurisdiction (eg. US-FED or DEFAULT): ";
+	std::getline(std::cin >> std::ws, emp.jurisdiction);
+
+	std::cout << "Filing Status (eg. single or married): ";
+	std::getline(std::cin >> std::ws, emp.filingStatus);
+
+	std::string hireDate;
+	std::cout << "Hire Date (00-00-0000 || day-month-year): ";
+	std::getline(std::cin >> std::ws, hireDate);
+	if (!Date::parse(hireDate, emp.hireDate)) {
+		std::cout << "\nInvalid Date! (00-00-0000 || 01-01-2026)\n";
+		Utils::Pause();
+
+		return;
+	}
 
 	std::cout << "Hourly Pay Rate: ";
 	if (!(std::cin >> emp.hourlyRate)) {
@@ -492,7 +1233,10 @@ void PayrollManager::createEmployee(Database& db) {
 		emp.isActive = active == 'y';
 	}
 
-	bool success = db.addEmployee(emp);
+	bool success = db.internDepartment(department, emp.departmentID)
+		&& db.internEmploymentType(employmentType, emp.employmentTypeID)
+		&& db.addEmployee(emp);
+
 	if (success)
 		std::cout << "\nEmployee Successfully Added\n";
 
@@ -500,6 +1244,70 @@ void PayrollManager::createEmployee(Database& db) {
 	Utils::Pause();
 }
 
+// Asks for part of a name or department and lists the best matches to pick an ID from. //
+// An ID typed at the search prompt is taken as is                                       //
+bool PayrollManager::pickEmployee(Database& db, int& employeeID) {
+	std::string query;
+	std::cout << "Search Employee (name, department or ID): ";
+	std::getline(std::cin >> std::ws, query);
+
+	if (std::all_of(query.begin(), query.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+		std::istringstream idStream(query);
+		if (idStream >> employeeID)
+			return true;
+
+		std::cout << "\nInvalid Input\n";
+		Utils::Pause();
+
+		return false;
+	}
+
+	std::cout << '\n' << std::left << std::setw(8) << "ID"
+		<< std::setw(15) << "First Name"
+		<< std::setw(15) << "Last Name"
+		<< std::setw(20) << "Department"
+		<< std::setw(15) << "Hourly Rate"
+		<< std::setw(15) << "Status" << '\n';
+	std::cout << "-------------------------------------------------------------------------------------------\n";
+
+	int rowCount = db.searchEmployees(query, searchLimit, [&db](const Employee& emp) {
+		std::cout << std::left
+			<< std::setw(8) << emp.id
+			<< std::setw(15) << emp.firstName
+			<< std::setw(15) << emp.lastName
+			<< std::setw(20) << db.getDepartments().name(emp.departmentID)
+			<< std::setw(15) << emp.hourlyRate
+			<< std::setw(15) << (emp.isActive ? "Working" : "Resting") << '\n';
+
+		return true;
+	});
+
+	if (rowCount <= 0) {
+		if (rowCount == 0)
+			std::cout << "No Employee Found\n";
+
+		std::cout << '\n';
+		Utils::Pause();
+
+		return false;
+	}
+
+	if (rowCount == searchLimit)
+		std::cout << "(best " << searchLimit << " matches shown, type more of the name to narrow it down)\n";
+
+	std::cout << "\nEmployee ID: ";
+	if (!(std::cin >> employeeID)) {
+		std::cout << "\nInvalid Input\n";
+
+		Utils::ClearInputBuffer();
+		Utils::Pause();
+
+		return false;
+	}
+
+	return true;
+}
+
 void PayrollManager::viewEmployees(Database& db, bool waitForUserInput) {
 	if (waitForUserInput) {
 		system("cls");
@@ -515,25 +1323,32 @@ void PayrollManager::viewEmployees(Database& db, bool waitForUserInput) {
 		<< std::setw(15) << "Status" << '\n';
 	std::cout << "-----------------------------------------------------------------------------------------------\n";
 
-	std::vector<Employee> employees = db.getEmployees();
-	if (employees.empty()) {
+	EmployeeCursor cursor;
+	int rowCount, totalRows{ 0 };
+	do {
+		rowCount = db.getEmployeesPage(cursor, pageSize, [&db](const Employee& emp) {
+			std::cout << std::left
+				<< std::setw(5) << emp.id
+				<< std::setw(15) << emp.firstName
+				<< std::setw(15) << emp.lastName
+				<< std::setw(15) << db.getDepartments().name(emp.departmentID)
+				<< std::setw(15) << emp.hireDate.toString()
+				<< std::setw(15) << emp.hourlyRate
+				<< std::setw(15) << (emp.isActive ? "Working" : "Resting") << '\n';
+
+			return true;
+		});
+
+		totalRows += rowCount > 0 ? rowCount : 0;
+	} while (rowCount == pageSize && (!waitForUserInput || Utils::NextPage()));
+
+	if (totalRows == 0) {
 		std::cout << "No Employee Found\n\n";
 		Utils::Pause();
 
 		return;
 	}
 
-	for (Employee& emp : employees) {
-		std::cout << std::left
-			<< std::setw(5) << emp.id
-			<< std::setw(15) << emp.firstName
-			<< std::setw(15) << emp.lastName
-			<< std::setw(15) << emp.department
-			<< std::setw(15) << emp.hireDate
-			<< std::setw(15) << emp.hourlyRate
-			<< std::setw(15) << (emp.isActive ? "Working" : "Resting") << '\n';
-	}
-
 	std::cout << "\n";
 	if (waitForUserInput) { Utils::Pause(); }
 }
@@ -3,33 +3,60 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
-#include <regex>
 #include <ctype.h>
 
 #include "../Utilities.h"
+#include "../models/Date.h"
 #include "../models/Employee.h"
 #include "../models/Payroll.h"
 #include "../models/EmployeePayroll.h"
+#include "../models/PayrollYtd.h"
 #include "../models/TimeEntry.h"
+#include "../models/ImportSummary.h"
 
 #include "../database/Database.h"
 #include "../registration/Registration.h"
+#include "../tax/TaxEngine.h"
+#include "PayRules.h"
+#include "../reports/LaborCostReport.h"
+#include "../reports/PayStubGenerator.h"
 
 class Database;
 
 class PayrollManager
 {
+private:
+	static constexpr int pageSize{ 25 }; // Rows shown per page in listing screens
+	static constexpr int searchLimit{ 15 }; // Best matches shown when searching for an employee
+
+	TaxEngine taxEngine;
+	PayRules payRules;
+
+	bool pickEmployee(Database& db, int& employeeID);
 public:
+	bool loadTaxTables(const std::string& fileName);
+	bool loadPayRules(const std::string& fileName);
 	bool setupPayroll(Database& db, AuthManager& auth);
 	void createPayPeriod(Database& db);
 	void deletePayPeriod(Database& db);
 	void viewPayPeriods(Database& db, bool waitForUserInput);
 	void processPayroll(Database& db);
+	void reprocessPayroll(Database& db);
+	void processOpenPayrolls(Database& db);
+	void simulatePayroll(Database& db);
 	void viewPayrollRecords(Database& db);
 	void viewEmployeePayrollHistory(Database& db);
+	void rebuildYearToDateTotals(Database& db);
+	void viewLaborCostReport(Database& db);
+	void generatePayStubs(Database& db);
+	void auditTimeEntryCoverage(Database& db);
 	void viewTimeEntries(Database& db, bool waitForUserInput);
 	void enterEmployeeHours(Database& db);
+	void importTimeEntries(Database& db);
+	void archiveTimeEntries(Database& db);
 	void toggleEmployeeStatus(Database& db);
+	void manageDeductions(Database& db);
+	void addDeduction(Database& db, int employeeID);
 	void createEmployee(Database& db);
 	void viewEmployees(Database& db, bool waitForUserInput);
 };
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <iomanip>
+#include "LaborCostReport.h"
+
+double LaborCostReport::value(const DepartmentTotals& totals, Measure measure) {
+	switch (measure) {
+		case Measure::NetPay: return totals.netPay;
+		case Measure::Tax: return totals.tax;
+		case Measure::HoursWorked: return totals.hoursWorked;
+		default: return totals.grossPay;
+	}
+}
+
+bool LaborCostReport::load(Database& db, int year) {
+	std::vector<DepartmentTotals> rows;
+
+	periods.clear();
+	departmentIDs.clear();
+	cells.clear();
+
+	int rowCount = db.getDepartmentTotals(year, [&rows](const DepartmentTotals& totals) {
+		rows.push_back(totals);
+		return true;
+	});
+
+	if (rowCount < 0)
+		return false;
+
+	// Rows arrive ordered by period, so a new period starts whenever the id changes //
+	for (const DepartmentTotals& row : rows) {
+		if (periods.empty() || periods.back().id != row.payPeriodID)
+			periods.push_back({ row.payPeriodID, row.startDate, row.endDate });
+
+		departmentIDs.push_back(row.departmentID);
+	}
+
+	std::sort(departmentIDs.begin(), departmentIDs.end());
+	departmentIDs.erase(std::unique(departmentIDs.begin(), departmentIDs.end()), departmentIDs.end());
+
+	cells.assign(periods.size() * departmentIDs.size(), DepartmentTotals());
+
+	size_t periodIndex{ 0 };
+	for (const DepartmentTotals& row : rows) {
+		while (periods[periodIndex].id != row.payPeriodID)
+			periodIndex++;
+
+		size_t column = static_cast<size_t>(std::lower_bound(departmentIDs.begin(), departmentIDs.end(), row.departmentID) - departmentIDs.begin());
+		cells[periodIndex * departmentIDs.size() + column] = row;
+	}
+
+	return true;
+}
+
+void LaborCostReport::render(std::ostream& out, const Dictionary& departments, Measure measure) const {
+	const int periodWidth{ 25 };
+	const int columnWidth{ 15 };
+
+	std::vector<double> columnTotals(departmentIDs.size(), 0.0);
+	double grandTotal{ 0.0 };
+
+	out << std::left << std::setw(periodWidth) << "Pay Period";
+	for (int departmentID : departmentIDs) {
+		std::string name = departmentID == 0 ? "(None)" : departments.name(departmentID);
+		out << std::setw(columnWidth) << name.substr(0, columnWidth - 1);
+	}
+	out << std::setw(columnWidth) << "Total" << '\n';
+	out << std::string(periodWidth + columnWidth * (departmentIDs.size() + 1), '-') << '\n';
+
+	out << std::fixed << std::setprecision(2);
+
+	for (size_t periodIndex = 0; periodIndex < periods.size(); periodIndex++) {
+		const Period& period = periods[periodIndex];
+		double rowTotal{ 0.0 };
+
+		out << std::left << std::setw(periodWidth) << (period.startDate.toString() + " - " + period.endDate.toString());
+		for (size_t column = 0; column < departmentIDs.size(); column++) {
+			double cell = value(cells[periodIndex * departmentIDs.size() + column], measure);
+
+			rowTotal += cell;
+			columnTotals[column] += cell;
+			out << std::setw(columnWidth) << cell;
+		}
+
+		grandTotal += rowTotal;
+		out << std::setw(columnWidth) << rowTotal << '\n';
+	}
+
+	out << std::string(periodWidth + columnWidth * (departmentIDs.size() + 1), '-') << '\n';
+	out << std::setw(periodWidth) << "Total";
+	for (double columnTotal : columnTotals)
+		out << std::setw(columnWidth) << columnTotal;
+	out << std::setw(columnWidth) << grandTotal << '\n';
+
+	out << std::defaultfloat;
+}
+
+bool LaborCostReport::empty() const {
+	return periods.empty();
+}
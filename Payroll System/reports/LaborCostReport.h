@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "../database/Database.h"
+#include "../models/DepartmentTotals.h"
+#include "../models/Dictionary.h"
+
+// Pivots the department x pay period cube for one year: a row per pay period, a column per department, //
+// with totals on both axes. Built from payroll_department_totals only, payroll rows are never read      //
+class LaborCostReport
+{
+public:
+	enum class Measure { GrossPay, NetPay, Tax, HoursWorked };
+private:
+	struct Period {
+		int id;
+		Date startDate;
+		Date endDate;
+	};
+
+	std::vector<Period> periods;
+	std::vector<int> departmentIDs;
+	std::vector<DepartmentTotals> cells; // periods.size() x departmentIDs.size(), row-major
+
+	static double value(const DepartmentTotals& totals, Measure measure);
+public:
+	bool load(Database& db, int year);
+	void render(std::ostream& out, const Dictionary& departments, Measure measure) const;
+	bool empty() const;
+};
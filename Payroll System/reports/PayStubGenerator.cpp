@@ -0,0 +1,195 @@
+#include <iostream>
+#include <thread>
+#include <cstdio>
+#include <filesystem>
+#include "PayStubGenerator.h"
+
+PayStubGenerator::PayStubGenerator(const Dictionary& departments, unsigned int workerCount) : departments(departments), workerCount(workerCount) {
+	if (this->workerCount == 0)
+		this->workerCount = std::thread::hardware_concurrency();
+
+	if (this->workerCount == 0)
+		this->workerCount = 1;
+}
+
+void PayStubGenerator::formatStub(const PayStub& stub, std::string& buffer) const {
+	char line[128];
+	char startDate[11], endDate[11];
+	stub.startDate.format(startDate);
+	stub.endDate.format(endDate);
+
+	auto append = [&buffer, &line](int length) {
+		if (length > 0)
+			buffer.append(line, static_cast<size_t>(length) < sizeof(line) ? static_cast<size_t>(length) : sizeof(line) - 1);
+	};
+
+	auto amounts = [&](const char* label, double period, double yearToDate) {
+		append(std::snprintf(line, sizeof(line), "%-20s %18.2f %18.2f\n", label, period, yearToDate));
+	};
+
+	const std::string& department = departments.name(stub.departmentID);
+
+	buffer.append("============================================================\n");
+	append(std::snprintf(line, sizeof(line), "PAY STUB %51s\n", ("Pay Period " + std::to_string(stub.payPeriodID)).c_str()));
+	buffer.append("------------------------------------------------------------\n");
+	append(std::snprintf(line, sizeof(line), "Employee:    %s, %s (ID %d)\n", stub.lastName.c_str(), stub.firstName.c_str(), stub.employeeID));
+	append(std::snprintf(line, sizeof(line), "Department:  %s\n", department.empty() ? "-" : department.c_str()));
+	append(std::snprintf(line, sizeof(line), "Period:      %s to %s\n", startDate, endDate));
+	append(std::snprintf(line, sizeof(line), "Hourly Rate: %.2f\n", stub.hourlyRate));
+	buffer.append("------------------------------------------------------------\n");
+	append(std::snprintf(line, sizeof(line), "%-20s %18s %13s %4d\n", "", "This Period", "Year To Date", stub.ytd.year));
+	amounts("Hours Worked", stub.hoursWorked, stub.ytd.hoursWorked);
+	amounts("Gross Pay", stub.grossPay, stub.ytd.grossPay);
+	amounts("Tax", stub.tax, stub.ytd.tax);
+	amounts("Deductions", stub.grossPay - stub.tax - stub.netPay, stub.ytd.grossPay - stub.ytd.tax - stub.ytd.netPay);
+	amounts("Net Pay", stub.netPay, stub.ytd.netPay);
+	buffer.append("============================================================\n\n");
+}
+
+// Blocks while the queue holds two batches per worker, so reading never runs far ahead of formatting //
+void PayStubGenerator::enqueue(Batch& batch) {
+	std::unique_lock<std::mutex> lock(queueMutex);
+	batchTaken.wait(lock, [this]() { return queue.size() < workerCount * 2; });
+
+	queue.push_back(std::move(batch));
+	batchQueued.notify_one();
+}
+
+void PayStubGenerator::work(Output output, const std::string& path) {
+	std::string buffer;
+	std::string fileName;
+	buffer.reserve(batchSize * 1024);
+
+	while (true) {
+		Batch batch;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			batchQueued.wait(lock, [this]() { return !queue.empty() || readingDone; });
+
+			if (queue.empty())
+				return;
+
+			batch = std::move(queue.front());
+			queue.pop_front();
+			batchTaken.notify_one();
+		}
+
+		if (output == Output::Directory) {
+			for (const PayStub& stub : batch.stubs) {
+				if (failed)
+					break;
+
+				buffer.clear();
+				formatStub(stub, buffer);
+
+				fileName = path;
+				fileName += "/stub_";
+				fileName += std::to_string(stub.payPeriodID);
+				fileName += '_';
+				fileName += std::to_string(stub.employeeID);
+				fileName += ".txt";
+
+				std::ofstream file(fileName, std::ios::binary);
+				if (!file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+					std::cerr << "\nError: Could not write " << fileName << '\n';
+					failed = true;
+					break;
+				}
+
+				stubsWritten++;
+			}
+
+			continue;
+		}
+
+		// Archive: format the whole batch, then wait for the batches before it so the file stays in employee order //
+		buffer.clear();
+		for (const PayStub& stub : batch.stubs)
+			formatStub(stub, buffer);
+
+		std::unique_lock<std::mutex> lock(archiveMutex);
+		archiveTurn.wait(lock, [this, &batch]() { return nextArchiveSequence == batch.sequence; });
+
+		if (!failed) {
+			if (archive.write(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+				stubsWritten += static_cast<int>(batch.stubs.size());
+			else {
+				std::cerr << "\nError: Could not write " << path << '\n';
+				failed = true;
+			}
+		}
+
+		nextArchiveSequence++;
+		archiveTurn.notify_all();
+	}
+}
+
+bool PayStubGenerator::generate(Database& db, int payPeriodID, Output output, const std::string& path, int& stubCount) {
+	stubCount = 0;
+	queue.clear();
+	readingDone = false;
+	nextArchiveSequence = 0;
+	failed = false;
+	stubsWritten = 0;
+
+	if (output == Output::Directory) {
+		std::error_code error;
+		std::filesystem::create_directories(path, error);
+		if (error) {
+			std::cerr << "\nError: Could not create directory " << path << ": " << error.message() << '\n';
+			return false;
+		}
+	}
+	else {
+		archive.clear();
+		archive.open(path, std::ios::binary | std::ios::trunc);
+		if (!archive.is_open()) {
+			std::cerr << "\nError: Could not open " << path << '\n';
+			return false;
+		}
+	}
+
+	std::vector<std::thread> workers;
+	for (unsigned int i = 0; i < workerCount; i++)
+		workers.emplace_back(&PayStubGenerator::work, this, output, std::cref(path));
+
+	Batch batch{ 0, {} };
+	batch.stubs.reserve(batchSize);
+	size_t nextSequence{ 0 };
+
+	int rowCount = db.getPayStubs(payPeriodID, [&](const PayStub& stub) {
+		batch.stubs.push_back(stub);
+
+		if (batch.stubs.size() == batchSize) {
+			enqueue(batch);
+
+			batch = Batch{ ++nextSequence, {} };
+			batch.stubs.reserve(batchSize);
+		}
+
+		return !failed;
+	});
+
+	if (!batch.stubs.empty())
+		enqueue(batch);
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		readingDone = true;
+	}
+	batchQueued.notify_all();
+
+	for (std::thread& worker : workers)
+		worker.join();
+
+	if (output == Output::Archive) {
+		archive.close();
+		if (archive.fail() && !failed) {
+			std::cerr << "\nError: Could not write " << path << '\n';
+			failed = true;
+		}
+	}
+
+	stubCount = stubsWritten;
+	return rowCount >= 0 && !failed;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+
+#include "../database/Database.h"
+#include "../models/PayStub.h"
+#include "../models/Dictionary.h"
+
+// Writes a pay stub per employee for one pay period. The calling thread streams the joined payroll rows //
+// in batches to a pool of workers, each formatting into its own reusable buffer, so SQLite is only ever  //
+// touched by the caller. Output is one file per employee in a directory, or a single archive file with  //
+// the stubs concatenated in employee order                                                               //
+class PayStubGenerator
+{
+public:
+	enum class Output { Directory, Archive };
+private:
+	static constexpr size_t batchSize{ 256 };
+
+	struct Batch {
+		size_t sequence;
+		std::vector<PayStub> stubs;
+	};
+
+	const Dictionary& departments;
+	unsigned int workerCount;
+
+	std::mutex queueMutex;
+	std::condition_variable batchQueued;
+	std::condition_variable batchTaken;
+	std::deque<Batch> queue;
+	bool readingDone{ false };
+
+	std::mutex archiveMutex;
+	std::condition_variable archiveTurn;
+	size_t nextArchiveSequence{ 0 };
+	std::ofstream archive;
+
+	std::atomic<bool> failed{ false };
+	std::atomic<int> stubsWritten{ 0 };
+
+	void formatStub(const PayStub& stub, std::string& buffer) const;
+	void enqueue(Batch& batch);
+	void work(Output output, const std::string& path);
+public:
+	// workerCount 0 uses one worker per hardware thread //
+	explicit PayStubGenerator(const Dictionary& departments, unsigned int workerCount = 0);
+
+	bool generate(Database& db, int payPeriodID, Output output, const std::string& path, int& stubCount);
+};
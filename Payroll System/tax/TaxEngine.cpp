@@ -0,0 +1,180 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include "TaxEngine.h"
+
+// -------- //
+// TaxTable //
+// -------- //
+
+bool TaxTable::compile(std::vector<TaxBracket> brackets) {
+	if (brackets.empty())
+		return false;
+
+	std::sort(brackets.begin(), brackets.end(), [](const TaxBracket& a, const TaxBracket& b) {
+		return a.threshold < b.threshold;
+	});
+
+	// Income below the first listed threshold is untaxed //
+	if (brackets.front().threshold > 0.0)
+		brackets.insert(brackets.begin(), TaxBracket{ 0.0, 0.0 });
+
+	thresholds.clear();
+	rates.clear();
+	cumulativeTax.clear();
+
+	double cumulative{ 0.0 };
+	for (size_t i = 0; i < brackets.size(); i++) {
+		if (brackets[i].rate < 0.0 || brackets[i].rate > 1.0)
+			return false;
+
+		if (i > 0)
+			cumulative += (brackets[i].threshold - brackets[i - 1].threshold) * brackets[i - 1].rate;
+
+		thresholds.push_back(brackets[i].threshold);
+		rates.push_back(brackets[i].rate);
+		cumulativeTax.push_back(cumulative);
+	}
+
+	return true;
+}
+
+double TaxTable::computeTax(double annualIncome) const {
+	if (annualIncome <= 0.0 || thresholds.empty())
+		return 0.0;
+
+	// Branchless binary search for the last threshold <= income (thresholds[0] is always 0) //
+	const double* base = thresholds.data();
+	size_t length = thresholds.size();
+	while (length > 1) {
+		size_t half = length / 2;
+		base = (base[half] <= annualIncome) ? base + half : base;
+		length -= half;
+	}
+
+	size_t bracket = static_cast<size_t>(base - thresholds.data());
+	return cumulativeTax[bracket] + (annualIncome - thresholds[bracket]) * rates[bracket];
+}
+
+// --------- //
+// TaxEngine //
+// --------- //
+
+TaxEngine::TaxEngine() {
+	// Built-in fallback: flat 15% for anyone without a matching table //
+	TaxTable flatTable;
+	flatTable.compile({ { 0.0, 0.15 } });
+
+	tables.push_back(flatTable);
+	tableIndex[makeKey("DEFAULT", "single")] = 0;
+}
+
+std::string TaxEngine::makeKey(const std::string& jurisdiction, const std::string& filingStatus) {
+	return jurisdiction + "|" + filingStatus;
+}
+
+// Fields without the spaces around them or the \r left by files saved on Windows //
+static std::string trimField(const std::string& field) {
+	size_t first = field.find_first_not_of(" \t\r");
+	if (first == std::string::npos)
+		return "";
+
+	return field.substr(first, field.find_last_not_of(" \t\r") - first + 1);
+}
+
+// File format (one bracket per line): jurisdiction,filing_status,threshold,rate_percent.       //
+// The whole file is checked before any table is replaced, so a bad line leaves the old tables //
+bool TaxEngine::loadFromFile(const std::string& fileName) {
+	std::ifstream file(fileName);
+	if (!file) {
+		std::cerr << "Tax table file " << fileName << " not found, using the built-in DEFAULT table (flat 15%)\n";
+		return false;
+	}
+
+	std::map<std::string, std::vector<TaxBracket>> parsedBrackets;
+	std::string line;
+	int lineNumber{ 0 };
+
+	while (std::getline(file, line)) {
+		lineNumber++;
+
+		line = trimField(line);
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream fields(line);
+		std::string jurisdiction, filingStatus, threshold, rate, extra;
+		std::getline(fields, jurisdiction, ',');
+		std::getline(fields, filingStatus, ',');
+		std::getline(fields, threshold, ',');
+		std::getline(fields, rate, ',');
+
+		jurisdiction = trimField(jurisdiction);
+		filingStatus = trimField(filingStatus);
+		threshold = trimField(threshold);
+		rate = trimField(rate);
+
+		try {
+			size_t thresholdEnd{ 0 }, rateEnd{ 0 };
+			double thresholdValue = std::stod(threshold, &thresholdEnd);
+			double rateValue = std::stod(rate, &rateEnd);
+
+			if (jurisdiction.empty() || filingStatus.empty() || thresholdEnd != threshold.size() || rateEnd != rate.size()
+				|| std::getline(fields, extra, ','))
+				throw std::invalid_argument("malformed line");
+
+			parsedBrackets[makeKey(jurisdiction, filingStatus)].push_back({ thresholdValue, rateValue / 100.0 });
+		}
+		catch (const std::exception&) {
+			std::cerr << "Invalid tax bracket on line " << lineNumber << " of " << fileName << ", no tax tables were loaded from it\n";
+			return false;
+		}
+	}
+
+	std::vector<std::pair<std::string, TaxTable>> compiled;
+	for (auto& [key, brackets] : parsedBrackets) {
+		TaxTable table;
+		if (!table.compile(brackets)) {
+			std::cerr << "Invalid tax table " << key << " in " << fileName << ", no tax tables were loaded from it\n";
+			return false;
+		}
+
+		compiled.emplace_back(key, table);
+	}
+
+	for (auto& [key, table] : compiled) {
+		auto existing = tableIndex.find(key);
+		if (existing != tableIndex.end()) {
+			tables[existing->second] = table;
+		}
+		else {
+			tableIndex[key] = static_cast<int>(tables.size());
+			tables.push_back(table);
+		}
+	}
+
+	return true;
+}
+
+int TaxEngine::findTable(const std::string& jurisdiction, const std::string& filingStatus) const {
+	auto match = tableIndex.find(makeKey(jurisdiction, filingStatus));
+	if (match != tableIndex.end())
+		return match->second;
+
+	match = tableIndex.find(makeKey("DEFAULT", filingStatus));
+	if (match != tableIndex.end())
+		return match->second;
+
+	// Table 0 is always DEFAULT|single: flat 15% unless tax_tables.csv redefines it //
+	return 0;
+}
+
+double TaxEngine::computeTax(int table, double annualIncome) const {
+	return tables[table].computeTax(annualIncome);
+}
+
+size_t TaxEngine::tableCount() const {
+	return tables.size();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+struct TaxBracket {
+	double threshold; // Annual income where this bracket starts
+	double rate;      // Fraction taxed above threshold (0.22 = 22%)
+};
+
+// Progressive brackets compiled into flat arrays: sorted thresholds, the rate above each
+// threshold and the cumulative tax owed at each threshold. Lookups never allocate.
+class TaxTable
+{
+private:
+	std::vector<double> thresholds;
+	std::vector<double> rates;
+	std::vector<double> cumulativeTax;
+public:
+	bool compile(std::vector<TaxBracket> brackets);
+	double computeTax(double annualIncome) const;
+};
+
+class TaxEngine
+{
+private:
+	std::vector<TaxTable> tables;
+	std::unordered_map<std::string, int> tableIndex; // "jurisdiction|filing status" --> index into tables
+
+	static std::string makeKey(const std::string& jurisdiction, const std::string& filingStatus);
+public:
+	TaxEngine();
+
+	bool loadFromFile(const std::string& fileName);
+	int findTable(const std::string& jurisdiction, const std::string& filingStatus) const;
+	double computeTax(int table, double annualIncome) const;
+	size_t tableCount() const;
+};
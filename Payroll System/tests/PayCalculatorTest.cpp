@@ -0,0 +1,69 @@
+// Overtime checks for PayCalculator with the default pay rules (8 hours a day, 40 a week, 1.5x). //
+// Exits with 1 when any check fails.                                                              //
+//                                                                                                 //
+// Usage: PayCalculatorTest                                                                        //
+
+#include <iostream>
+#include <cmath>
+#include <string>
+
+#include "../payroll/PayCalculator.h"
+
+static int failures{ 0 };
+
+static void expect(const std::string& name, double actual, double expected) {
+	if (std::fabs(actual - expected) < 1e-9)
+		return;
+
+	std::cerr << "FAIL " << name << ": expected " << expected << ", got " << actual << '\n';
+	failures++;
+}
+
+// Pays a 14 day period starting on Monday 2025-01-06 at 10 an hour, one entry per listed day //
+static PayResult payFor(const double* dayHours, int days) {
+	TaxEngine taxEngine;
+	PayRules payRules;
+	Date startDate = Date::fromCivil(2025, 1, 6);
+	PayCalculator calculator(taxEngine, payRules, startDate, Date{ startDate.days + 13 });
+
+	HoursAccumulator hours;
+	for (int day = 0; day < days; day++) {
+		if (dayHours[day] > 0.0)
+			calculator.addEntry(hours, Date{ startDate.days + day }, dayHours[day], -1);
+	}
+
+	return calculator.calculate(hours, 10.0, 0);
+}
+
+int main() {
+	// Daily (5 x 2) and weekly (50 - 40) overtime are the same 10 hours, paid once //
+	const double fiveTenHourDays[] = { 10, 10, 10, 10, 10 };
+	PayResult result = payFor(fiveTenHourDays, 5);
+	expect("5 x 10h overtime", result.overtimeHours, 10.0);
+	expect("5 x 10h gross", result.grossPay, 40 * 10.0 + 10 * 15.0);
+
+	// Weekly limit only //
+	const double sixEightHourDays[] = { 8, 8, 8, 8, 8, 8 };
+	result = payFor(sixEightHourDays, 6);
+	expect("6 x 8h overtime", result.overtimeHours, 8.0);
+
+	// Daily limit only: 16 hours of daily overtime beat 8 hours over the weekly limit //
+	const double fourTwelveHourDays[] = { 12, 12, 12, 12 };
+	result = payFor(fourTwelveHourDays, 4);
+	expect("4 x 12h overtime", result.overtimeHours, 16.0);
+
+	// Weekly overtime above the daily overtime: 6 x 9h = 6 daily, 54 - 40 = 14 weekly //
+	const double sixNineHourDays[] = { 9, 9, 9, 9, 9, 9 };
+	result = payFor(sixNineHourDays, 6);
+	expect("6 x 9h overtime", result.overtimeHours, 14.0);
+
+	// Each week is counted on its own //
+	const double twoWeeks[] = { 10, 10, 10, 10, 10, 0, 0, 10, 10, 10, 10, 10 };
+	result = payFor(twoWeeks, 12);
+	expect("2 weeks of 5 x 10h overtime", result.overtimeHours, 20.0);
+
+	if (failures == 0)
+		std::cout << "All pay calculator checks passed\n";
+
+	return failures == 0 ? 0 : 1;
+}